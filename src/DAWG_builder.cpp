@@ -0,0 +1,265 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+#include <unordered_set>
+#include <algorithm>
+#include <iomanip>
+#include "algorithms/json.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+
+// Xây dựng DFA tối thiểu không chu trình trực tiếp từ danh sách từ đã sắp xếp
+// (Daciuk, Mihov, Watson, Watson 2000). Chỉ các trạng thái trên đường đi của từ
+// vừa thêm là chưa tối thiểu; mọi trạng thái khác nằm trong "register" và là duy
+// nhất theo (final, các cạnh ra). Bộ nhớ chỉ tỉ lệ với DFA tối thiểu.
+
+// === PHẦN 1: CẤU TRÚC DFA (giống các solver) ===
+struct DFA {
+    set<int> states;
+    set<int> alphabet;
+    map<int, map<int, int>> transitions;
+    int start_state = -1;
+    set<int> final_states;
+    
+    map<int, string> state_id_to_name;
+    map<string, int> state_name_to_id;
+    map<int, string> input_id_to_char;
+    map<string, int> input_char_to_id;
+    int state_counter = 0;
+    int input_counter = 0;
+
+    int getStateID(string name) {
+        if (state_name_to_id.find(name) == state_name_to_id.end()) {
+            state_name_to_id[name] = state_counter;
+            state_id_to_name[state_counter] = name;
+            states.insert(state_counter);
+            state_counter++;
+        }
+        return state_name_to_id[name];
+    }
+    int getInputID(string char_str) {
+        if (input_char_to_id.find(char_str) == input_char_to_id.end()) {
+            input_char_to_id[char_str] = input_counter;
+            input_id_to_char[input_counter] = char_str;
+            alphabet.insert(input_counter);
+            input_counter++;
+        }
+        return input_char_to_id[char_str];
+    }
+    void addTransition(string from, string input_char, string to) {
+        int u = getStateID(from);
+        int v = getStateID(to);
+        int c = getInputID(input_char);
+        transitions[u][c] = v;
+    }
+    void setStart(string name) { start_state = getStateID(name); }
+    void addFinal(string name) { final_states.insert(getStateID(name)); }
+};
+
+void exportDFA_JSON(const DFA& dfa, string filename) {
+    json j_out = json::array();
+    for (int u : dfa.states) {
+        json j_s;
+        j_s["state_name"] = dfa.state_id_to_name.at(u);
+        j_s["is_start"] = (u == dfa.start_state);
+        j_s["is_end"] = (dfa.final_states.count(u) > 0);
+        json j_trans = json::array();
+        if (dfa.transitions.count(u)) {
+            for (auto const& p : dfa.transitions.at(u)) {
+                json t;
+                t["input"] = dfa.input_id_to_char.at(p.first);
+                t["target_state"] = dfa.state_id_to_name.at(p.second);
+                j_trans.push_back(t);
+            }
+        }
+        j_s["transitions"] = j_trans;
+        j_out.push_back(j_s);
+    }
+    ofstream o(filename); o << std::setw(4) << j_out;
+}
+
+// === PHẦN 2: BUILDER ===
+class IncrementalBuilder {
+private:
+    struct Node {
+        bool final = false;
+        vector<pair<int, int>> edges; // (symbol, target), theo thứ tự từ điển của symbol
+    };
+
+    struct NodeHash {
+        const vector<Node>* nodes;
+        size_t operator()(int id) const {
+            const Node& n = (*nodes)[id];
+            size_t h = n.final ? 0x9e3779b97f4a7c15ULL : 0;
+            for (auto const& e : n.edges) {
+                h ^= (size_t)e.first + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+                h ^= (size_t)e.second + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            }
+            return h;
+        }
+    };
+    struct NodeEqual {
+        const vector<Node>* nodes;
+        bool operator()(int a, int b) const {
+            const Node& x = (*nodes)[a];
+            const Node& y = (*nodes)[b];
+            return x.final == y.final && x.edges == y.edges;
+        }
+    };
+
+    vector<Node> nodes;
+    vector<int> free_ids;
+    unordered_set<int, NodeHash, NodeEqual> reg;
+
+    vector<int> path;          // path[i] = trạng thái sau i symbol của từ trước
+    vector<int> prev_symbols;  // Các symbol của từ trước
+    string prev_word;
+    bool has_prev = false;
+
+    vector<string> symbol_names;
+    map<string, int> symbol_ids;
+
+    int newNode() {
+        if (!free_ids.empty()) {
+            int id = free_ids.back(); free_ids.pop_back();
+            nodes[id] = Node();
+            return id;
+        }
+        nodes.emplace_back();
+        return nodes.size() - 1;
+    }
+
+    int symbolID(const string& s) {
+        auto it = symbol_ids.find(s);
+        if (it != symbol_ids.end()) return it->second;
+        symbol_names.push_back(s);
+        return symbol_ids[s] = symbol_names.size() - 1;
+    }
+
+    // Tách từ thành các ký tự UTF-8 (mỗi ký tự là một symbol)
+    vector<int> splitSymbols(const string& word) {
+        vector<int> out;
+        for (size_t i = 0; i < word.size();) {
+            size_t len = 1;
+            unsigned char b = word[i];
+            if (b >= 0xF0) len = 4; else if (b >= 0xE0) len = 3; else if (b >= 0xC0) len = 2;
+            len = min(len, word.size() - i);
+            out.push_back(symbolID(word.substr(i, len)));
+            i += len;
+        }
+        return out;
+    }
+
+    // Tối thiểu hóa phần đuôi của đường đi: path[depth+1 ..] được thay bằng
+    // trạng thái tương đương trong register hoặc được đưa vào register.
+    void replaceOrRegister(size_t depth) {
+        while (path.size() > depth + 1) {
+            int child = path.back(); path.pop_back();
+            int parent = path.back();
+            auto found = reg.find(child);
+            if (found != reg.end()) {
+                nodes[parent].edges.back().second = *found;
+                free_ids.push_back(child);
+            } else {
+                reg.insert(child);
+            }
+        }
+    }
+
+public:
+    IncrementalBuilder() : reg(1024, NodeHash{&nodes}, NodeEqual{&nodes}) {
+        path.push_back(newNode());
+    }
+
+    size_t liveStates() const { return nodes.size() - free_ids.size(); }
+
+    void addWord(const string& word) {
+        if (has_prev) {
+            if (word < prev_word) throw runtime_error("Danh sach tu chua duoc sap xep: \"" + prev_word + "\" > \"" + word + "\"");
+            if (word == prev_word) return;
+        }
+        vector<int> symbols = splitSymbols(word);
+
+        size_t common = 0;
+        while (common < symbols.size() && common < prev_symbols.size() && symbols[common] == prev_symbols[common]) common++;
+
+        replaceOrRegister(common);
+        for (size_t i = common; i < symbols.size(); ++i) {
+            int child = newNode();
+            nodes[path.back()].edges.push_back({symbols[i], child});
+            path.push_back(child);
+        }
+        nodes[path.back()].final = true;
+
+        prev_symbols.swap(symbols);
+        prev_word = word;
+        has_prev = true;
+    }
+
+    // Kết thúc: tối thiểu hóa đường đi còn lại rồi chuyển sang cấu trúc DFA chung
+    // (trạng thái được đặt tên q0, q1, ... theo thứ tự BFS từ trạng thái bắt đầu)
+    DFA finish() {
+        replaceOrRegister(0);
+        int root = path[0];
+
+        DFA dfa;
+        for (const string& s : symbol_names) dfa.getInputID(s);
+        vector<int> order = {root};
+        map<int, int> bfs_id = {{root, 0}};
+        for (size_t i = 0; i < order.size(); ++i)
+            for (auto const& e : nodes[order[i]].edges)
+                if (bfs_id.emplace(e.second, (int)order.size()).second) order.push_back(e.second);
+
+        for (size_t i = 0; i < order.size(); ++i) dfa.getStateID("q" + to_string(i));
+        dfa.setStart("q0");
+        for (size_t i = 0; i < order.size(); ++i) {
+            const Node& n = nodes[order[i]];
+            string name = "q" + to_string(i);
+            if (n.final) dfa.addFinal(name);
+            for (auto const& e : n.edges)
+                dfa.addTransition(name, symbol_names[e.first], "q" + to_string(bfs_id[e.second]));
+        }
+        return dfa;
+    }
+};
+
+// === PHẦN 3: HÀM MAIN ===
+// DAWG_builder <words.txt | -> <output.json>   (mỗi dòng một từ, đã sắp xếp theo byte)
+int main(int argc, char* argv[]) {
+    string inputFile = (argc > 1) ? argv[1] : "-";
+    string outputFile = (argc > 2) ? argv[2] : "output.json";
+
+    try {
+        ifstream file;
+        if (inputFile != "-") {
+            file.open(inputFile);
+            if (!file.is_open()) throw runtime_error("Khong mo duoc file input: " + inputFile);
+        }
+        istream& in = (inputFile == "-") ? cin : file;
+
+        IncrementalBuilder builder;
+        string word;
+        size_t words = 0, peakStates = 0;
+        while (getline(in, word)) {
+            if (!word.empty() && word.back() == '\r') word.pop_back();
+            builder.addWord(word);
+            words++;
+            peakStates = max(peakStates, builder.liveStates());
+        }
+
+        DFA dfa = builder.finish();
+        exportDFA_JSON(dfa, outputFile);
+
+        cout << "Words: " << words << endl;
+        cout << "Final_States: " << dfa.states.size() << endl;
+        cout << "Peak_Live_States: " << peakStates << endl;
+    } catch (const exception& e) {
+        cerr << "ERROR: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,274 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <numeric>
+#include "algorithms/json.hpp"
+
+using json = nlohmann::json;
+using namespace std;
+
+// Kiểm tra hai DFA có tương đương (cùng ngôn ngữ) hay không bằng thuật toán
+// Hopcroft-Karp: union-find trên tích của hai DFA, O(m * alpha(n)), không cần
+// tối thiểu hóa lại. Dừng sớm và trả về một từ phân biệt khi hai DFA khác nhau.
+// Nhãn đầu ra (is_end, accept_class) và output trên cạnh cũng phải trùng nhau.
+
+// === PHẦN 1: CẤU TRÚC DFA (giống các solver) ===
+struct DFA {
+    set<int> states;
+    set<int> alphabet;
+    map<int, map<int, int>> transitions;
+    int start_state = -1;
+    set<int> final_states;
+    map<int, string> accept_class;                 // Nhãn đầu ra của trạng thái
+    map<int, map<int, string>> transition_output;  // Output của cạnh (u, c)
+    
+    map<int, string> state_id_to_name;
+    map<string, int> state_name_to_id;
+    map<int, string> input_id_to_char;
+    map<string, int> input_char_to_id;
+    int state_counter = 0;
+    int input_counter = 0;
+
+    int getStateID(string name) {
+        if (state_name_to_id.find(name) == state_name_to_id.end()) {
+            state_name_to_id[name] = state_counter;
+            state_id_to_name[state_counter] = name;
+            states.insert(state_counter);
+            state_counter++;
+        }
+        return state_name_to_id[name];
+    }
+    int getInputID(string char_str) {
+        if (input_char_to_id.find(char_str) == input_char_to_id.end()) {
+            input_char_to_id[char_str] = input_counter;
+            input_id_to_char[input_counter] = char_str;
+            alphabet.insert(input_counter);
+            input_counter++;
+        }
+        return input_char_to_id[char_str];
+    }
+    void addTransition(string from, string input_char, string to) {
+        int u = getStateID(from);
+        int v = getStateID(to);
+        int c = getInputID(input_char);
+        transitions[u][c] = v;
+    }
+    void setStart(string name) { start_state = getStateID(name); }
+    void addFinal(string name) { final_states.insert(getStateID(name)); }
+};
+
+DFA loadDFA_JSON(string filename) {
+    ifstream f(filename);
+    if (!f.is_open()) throw runtime_error("Khong mo duoc file input: " + filename);
+    json j; f >> j;
+    DFA dfa;
+    for (auto& item : j) {
+        string s = item["state_name"];
+        dfa.getStateID(s);
+        if (item.value("is_start", false)) dfa.setStart(s);
+        if (item.value("is_end", false)) dfa.addFinal(s);
+        if (item.contains("accept_class")) dfa.accept_class[dfa.getStateID(s)] = item["accept_class"];
+        if (item.contains("transitions")) {
+            for (auto& t : item["transitions"]) {
+                dfa.addTransition(s, t["input"], t["target_state"]);
+                if (t.contains("output"))
+                    dfa.transition_output[dfa.getStateID(s)][dfa.getInputID(t["input"])] = t["output"];
+            }
+        }
+    }
+    return dfa;
+}
+
+// === PHẦN 2: KIỂM TRA TƯƠNG ĐƯƠNG ===
+struct EquivalenceResult {
+    bool equivalent = true;
+    vector<string> witness; // Từ phân biệt (dãy input), chỉ có nghĩa khi equivalent = false
+    // Phần khác nhau ở cuối từ phân biệt: {"a": ..., "b": ...}, mỗi bên là nhãn
+    // {"is_end", "accept_class"} của trạng thái hoặc {"output"} của cạnh cuối
+    json diverging;
+};
+
+class EquivalenceChecker {
+private:
+    // Đánh số chung: trạng thái của a là [0, na), trạng thái chết của a là na;
+    // trạng thái của b là [na + 1, na + 1 + nb), trạng thái chết của b là na + 1 + nb.
+    const DFA& a;
+    const DFA& b;
+    int na, nb;
+    vector<int> sym_a, sym_b; // symbol chung -> input id của a / b (-1 nếu không có)
+    vector<int> parent, rnk;
+
+    int sinkA() const { return na; }
+    int sinkB() const { return na + 1 + nb; }
+
+    int find(int x) {
+        while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; }
+        return x;
+    }
+    bool unite(int x, int y) {
+        x = find(x); y = find(y);
+        if (x == y) return false;
+        if (rnk[x] < rnk[y]) swap(x, y);
+        parent[y] = x;
+        if (rnk[x] == rnk[y]) rnk[x]++;
+        return true;
+    }
+
+    // Trạng thái x trong DFA của nó; trạng thái chết cho (nullptr, -1)
+    pair<const DFA*, int> locate(int x) const {
+        if (x < na) return {&a, x};
+        if (x > na && x < sinkB()) return {&b, x - na - 1};
+        return {nullptr, -1};
+    }
+    bool accepting(int x) const {
+        auto s = locate(x);
+        return s.first && s.first->final_states.count(s.second) > 0;
+    }
+    const string* acceptClass(int x) const {
+        auto s = locate(x);
+        if (!s.first) return nullptr;
+        auto ac = s.first->accept_class.find(s.second);
+        return ac == s.first->accept_class.end() ? nullptr : &ac->second;
+    }
+    // Output của cạnh (x, symbol chung c); nullptr nếu cạnh không có output
+    const string* output(int x, int c) const {
+        auto s = locate(x);
+        if (!s.first) return nullptr;
+        int sym = (s.first == &a) ? sym_a[c] : sym_b[c];
+        auto row = s.first->transition_output.find(s.second);
+        if (sym == -1 || row == s.first->transition_output.end()) return nullptr;
+        auto o = row->second.find(sym);
+        return o == row->second.end() ? nullptr : &o->second;
+    }
+    static bool sameString(const string* p, const string* q) {
+        return p == q || (p && q && *p == *q);
+    }
+    bool sameLabel(int x, int y) const {
+        return accepting(x) == accepting(y) && sameString(acceptClass(x), acceptClass(y));
+    }
+    // Chỉ dùng khi in phản ví dụ
+    json label(int x) const {
+        json l = {{"is_end", accepting(x)}};
+        if (const string* ac = acceptClass(x)) l["accept_class"] = *ac;
+        return l;
+    }
+    static json outputJson(const string* o) { return o ? json(*o) : json(nullptr); }
+    int next(int x, int c) const {
+        if (x < na) {
+            auto it = a.transitions.find(x);
+            if (sym_a[c] == -1 || it == a.transitions.end()) return sinkA();
+            auto t = it->second.find(sym_a[c]);
+            return t == it->second.end() ? sinkA() : t->second;
+        }
+        if (x > na && x < sinkB()) {
+            auto it = b.transitions.find(x - na - 1);
+            if (sym_b[c] == -1 || it == b.transitions.end()) return sinkB();
+            auto t = it->second.find(sym_b[c]);
+            return t == it->second.end() ? sinkB() : t->second + na + 1;
+        }
+        return x; // Trạng thái chết
+    }
+
+public:
+    vector<string> symbols; // Bảng chữ cái hợp của a và b, sắp xếp theo chuỗi
+
+    EquivalenceChecker(const DFA& dfa_a, const DFA& dfa_b)
+        : a(dfa_a), b(dfa_b), na(dfa_a.state_counter), nb(dfa_b.state_counter) {
+        set<string> all;
+        for (auto const& p : a.input_char_to_id) all.insert(p.first);
+        for (auto const& p : b.input_char_to_id) all.insert(p.first);
+        for (const string& s : all) {
+            symbols.push_back(s);
+            auto ia = a.input_char_to_id.find(s);
+            auto ib = b.input_char_to_id.find(s);
+            sym_a.push_back(ia == a.input_char_to_id.end() ? -1 : ia->second);
+            sym_b.push_back(ib == b.input_char_to_id.end() ? -1 : ib->second);
+        }
+    }
+
+    EquivalenceResult run() {
+        int total = na + nb + 2;
+        parent.resize(total);
+        iota(parent.begin(), parent.end(), 0);
+        rnk.assign(total, 0);
+
+        struct PairRecord { int x, y, from, symbol; };
+        vector<PairRecord> pairs;
+        auto witnessOf = [&](int idx) {
+            EquivalenceResult r;
+            r.equivalent = false;
+            for (; pairs[idx].from != -1; idx = pairs[idx].from) r.witness.push_back(symbols[pairs[idx].symbol]);
+            reverse(r.witness.begin(), r.witness.end());
+            return r;
+        };
+        auto labelMismatch = [&](int idx) {
+            EquivalenceResult r = witnessOf(idx);
+            r.diverging = {{"a", label(pairs[idx].x)}, {"b", label(pairs[idx].y)}};
+            return r;
+        };
+
+        int sa = (a.start_state == -1) ? sinkA() : a.start_state;
+        int sb = (b.start_state == -1) ? sinkB() : b.start_state + na + 1;
+        pairs.push_back({sa, sb, -1, -1});
+        unite(sa, sb);
+        if (!sameLabel(sa, sb)) return labelMismatch(0);
+
+        // BFS trên các cặp; mỗi lần hợp hai lớp sinh ra đúng một cặp mới. Mọi thành viên
+        // của một lớp nối với nhau qua các cặp đã duyệt, nên so output của từng cặp là đủ.
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            for (int c = 0; c < (int)symbols.size(); ++c) {
+                const string* ox = output(pairs[i].x, c);
+                const string* oy = output(pairs[i].y, c);
+                if (!sameString(ox, oy)) {
+                    EquivalenceResult r = witnessOf(i);
+                    r.witness.push_back(symbols[c]);
+                    r.diverging = {{"a", {{"output", outputJson(ox)}}}, {"b", {{"output", outputJson(oy)}}}};
+                    return r;
+                }
+                int x = next(pairs[i].x, c);
+                int y = next(pairs[i].y, c);
+                if (!unite(x, y)) continue;
+                pairs.push_back({x, y, (int)i, c});
+                if (!sameLabel(x, y)) return labelMismatch(pairs.size() - 1);
+            }
+        }
+        return EquivalenceResult();
+    }
+};
+
+EquivalenceResult checkEquivalence(const DFA& a, const DFA& b) {
+    EquivalenceChecker checker(a, b);
+    return checker.run();
+}
+
+// === PHẦN 3: HÀM MAIN ===
+// DFA_equivalence <a.json> <b.json>
+// Mã thoát: 0 = tương đương, 2 = khác nhau, 1 = lỗi
+int main(int argc, char* argv[]) {
+    if (argc < 3) {
+        cerr << "Usage: " << argv[0] << " <a.json> <b.json>" << endl;
+        return 1;
+    }
+    try {
+        DFA a = loadDFA_JSON(argv[1]);
+        DFA b = loadDFA_JSON(argv[2]);
+        EquivalenceResult r = checkEquivalence(a, b);
+
+        cout << "States_A: " << a.states.size() << endl;
+        cout << "States_B: " << b.states.size() << endl;
+        cout << "Same_Size: " << (a.states.size() == b.states.size() ? "YES" : "NO") << endl;
+        cout << "Equivalent: " << (r.equivalent ? "YES" : "NO") << endl;
+        if (!r.equivalent) {
+            cout << "Distinguishing_Word: " << json(r.witness).dump() << endl;
+            cout << "Diverging_Output: " << r.diverging.dump() << endl;
+        }
+        return r.equivalent ? 0 : 2;
+    } catch (const exception& e) {
+        cerr << "ERROR: " << e.what() << endl;
+        return 1;
+    }
+}
@@ -7,6 +7,8 @@
 #include <random>
 #include <algorithm>
 #include <ctime>
+#include <cstdint>
+#include <stdexcept>
 
 struct DFA {
     int num_states;
@@ -15,9 +17,12 @@ struct DFA {
     std::set<int> accepting_states;
     // transitions[state][char_index] = next_state
     std::vector<std::vector<int>> transitions;
+    // origin[state] = state of the base DFA this state was cloned from
+    std::vector<int> origin;
 
     DFA(int n, int alpha) : num_states(n), alphabet_size(alpha), start_state(0) {
         transitions.resize(n, std::vector<int>(alpha, 0));
+        for (int i = 0; i < n; ++i) origin.push_back(i);
     }
 };
 
@@ -67,6 +72,7 @@ void expand_dfa(DFA &dfa, int target_size) {
         // u' = u
         int u_prime = current_n; 
         dfa.transitions.push_back(dfa.transitions[u]); // Copy transitions outgoing from u
+        dfa.origin.push_back(dfa.origin[u]);            // u' is equivalent to whatever u is
         
         // if u is accepting, u' is also accepting
         if (dfa.accepting_states.count(u)) {
@@ -106,7 +112,7 @@ void write_single_dfa_json(std::ofstream &file, const DFA &dfa, bool is_last = f
         // Transitions
         file << "      \"transitions\": [\n";
         for (int c = 0; c < dfa.alphabet_size; ++c) {
-            std::string target_name = "S" + std::to_string(dfa.transitions[state][c]);
+            std::string target_name = 'A' + std::to_string(dfa.transitions[state][c]);
             file << "        {\n";
             file << "          \"input\": \"" << c << "\",\n";
             file << "          \"target_state\": \"" << target_name << "\"\n";
@@ -132,7 +138,213 @@ void write_single_dfa_json(std::ofstream &file, const DFA &dfa, bool is_last = f
     file << "  ]" << (is_last ? "" : ",") << "\n";
 }
 
-int main() {
+// 3. Ground truth (Moore refinement on the small base DFA, reachable states only)
+// min_class[s] = class of base state s in the minimal DFA, -1 if s is unreachable
+int compute_min_classes(const DFA &dfa, std::vector<int> &min_class) {
+    int n = dfa.num_states;
+    std::vector<bool> reachable(n, false);
+    std::vector<int> stack = {dfa.start_state};
+    reachable[dfa.start_state] = true;
+    while (!stack.empty()) {
+        int u = stack.back(); stack.pop_back();
+        for (int c = 0; c < dfa.alphabet_size; ++c) {
+            int v = dfa.transitions[u][c];
+            if (!reachable[v]) { reachable[v] = true; stack.push_back(v); }
+        }
+    }
+
+    std::vector<int> cls(n, -1);
+    for (int i = 0; i < n; ++i)
+        if (reachable[i]) cls[i] = dfa.accepting_states.count(i) ? 1 : 0;
+
+    int num_classes = 0;
+    while (true) {
+        std::map<std::vector<int>, int> signature_to_id;
+        std::vector<int> next(n, -1);
+        for (int i = 0; i < n; ++i) {
+            if (!reachable[i]) continue;
+            std::vector<int> signature = {cls[i]};
+            for (int c = 0; c < dfa.alphabet_size; ++c) signature.push_back(cls[dfa.transitions[i][c]]);
+            auto it = signature_to_id.find(signature);
+            if (it == signature_to_id.end()) it = signature_to_id.emplace(signature, (int)signature_to_id.size()).first;
+            next[i] = it->second;
+        }
+        bool stable = ((int)signature_to_id.size() == num_classes);
+        num_classes = signature_to_id.size();
+        cls = next;
+        if (stable) break;
+    }
+
+    min_class = cls;
+    return num_classes;
+}
+
+// Sidecar: expected minimal size + original->minimal mapping of an expanded DFA.
+// min_class[i] is the minimal state of "A<i>" (-1: unreachable), so a solver's
+// output can be checked in O(n) without running a second algorithm.
+void write_ground_truth_json(const std::string &filename, const DFA &expanded,
+                             const std::vector<int> &base_class, int expected_min_states) {
+    std::ofstream file(filename);
+    file << "{\n";
+    file << "  \"state_prefix\": \"A\",\n";
+    file << "  \"num_states\": " << expanded.num_states << ",\n";
+    file << "  \"expected_min_states\": " << expected_min_states << ",\n";
+    file << "  \"min_class\": [";
+    for (int state = 0; state < expanded.num_states; ++state) {
+        if (state > 0) file << ",";
+        file << base_class[expanded.origin[state]];
+    }
+    file << "]\n}\n";
+}
+
+// 4. Streaming random DFA generator (bounded memory)
+// Each row is generated and written immediately, nothing is materialized.
+// Transitions and acceptance flags come from two independent RNG streams
+// seeded from the same seed, so the JSON and binary outputs of one seed
+// describe the same DFA.
+//
+// Binary format (little-endian):
+//   [0..3]   magic "DFAB"
+//   [4..7]   uint32 version (= 1)
+//   [8..11]  uint32 num_states
+//   [12..15] uint32 alphabet_size
+//   [16..19] uint32 start_state
+//   [20..31] reserved (0)
+//   uint32 transitions[num_states * alphabet_size], row-major, 0xFFFFFFFF = none
+//   uint8  accepting[(num_states + 7) / 8], bit (s % 8) of byte (s / 8)
+const size_t STREAM_BUFFER_SIZE = 8 << 20;
+
+struct StreamWriter {
+    std::ofstream &file;
+    std::string buffer;
+
+    StreamWriter(std::ofstream &f) : file(f) { buffer.reserve(STREAM_BUFFER_SIZE + 4096); }
+    ~StreamWriter() { flush(); }
+
+    void flush() {
+        file.write(buffer.data(), buffer.size());
+        buffer.clear();
+    }
+    void append(const std::string &s) {
+        buffer += s;
+        if (buffer.size() >= STREAM_BUFFER_SIZE) flush();
+    }
+    void append_u32(uint32_t v) {
+        char bytes[4] = {(char)(v & 0xFF), (char)((v >> 8) & 0xFF), (char)((v >> 16) & 0xFF), (char)(v >> 24)};
+        buffer.append(bytes, 4);
+        if (buffer.size() >= STREAM_BUFFER_SIZE) flush();
+    }
+};
+
+void stream_random_dfa(const std::string &filename, uint32_t n, uint32_t alpha,
+                       bool binary, uint64_t seed) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file.is_open()) throw std::runtime_error("Khong mo duoc file output: " + filename);
+
+    std::mt19937_64 trans_rng(seed);
+    std::mt19937_64 accept_rng(seed ^ 0x9E3779B97F4A7C15ULL);
+    std::uniform_int_distribution<uint32_t> pick_target(0, n - 1);
+    std::uniform_int_distribution<int> pick_accept(0, 1);
+
+    StreamWriter out(file);
+    bool any_accepting = false;
+    // Ensure accepting states are not empty: the last state is forced when needed
+    auto next_accepting = [&](uint32_t state) {
+        bool acc = pick_accept(accept_rng) == 1;
+        if (state == n - 1 && !any_accepting) acc = true;
+        any_accepting = any_accepting || acc;
+        return acc;
+    };
+
+    if (binary) {
+        out.append(std::string("DFAB", 4));
+        out.append_u32(1);
+        out.append_u32(n);
+        out.append_u32(alpha);
+        out.append_u32(0);
+        out.append(std::string(12, '\0'));
+
+        for (uint64_t i = 0; i < (uint64_t)n * alpha; ++i) out.append_u32(pick_target(trans_rng));
+
+        uint8_t byte = 0;
+        for (uint32_t state = 0; state < n; ++state) {
+            if (next_accepting(state)) byte |= (uint8_t)(1u << (state % 8));
+            if (state % 8 == 7 || state == n - 1) {
+                out.append(std::string(1, (char)byte));
+                byte = 0;
+            }
+        }
+        return;
+    }
+
+    // JSON: same layout as write_single_dfa_json, one state at a time
+    std::string row;
+    out.append("[\n");
+    for (uint32_t state = 0; state < n; ++state) {
+        row.clear();
+        row += "    {\n      \"state_name\": \"A" + std::to_string(state) + "\",\n";
+        row += "      \"transitions\": [\n";
+        for (uint32_t c = 0; c < alpha; ++c) {
+            row += "        {\n          \"input\": \"" + std::to_string(c) + "\",\n";
+            row += "          \"target_state\": \"A" + std::to_string(pick_target(trans_rng)) + "\"\n        }";
+            row += (c < alpha - 1) ? ",\n" : "\n";
+        }
+        row += "      ],\n";
+        row += std::string("      \"is_start\": ") + (state == 0 ? "true" : "false") + ",\n";
+        row += std::string("      \"is_end\": ") + (next_accepting(state) ? "true" : "false") + "\n";
+        row += (state < n - 1) ? "    },\n" : "    }\n";
+        out.append(row);
+    }
+    out.append("]\n");
+}
+
+// Parse a decimal argument in [min_value, max_value]. std::stoull alone accepts "-1"
+// (wraps around), trailing garbage and values that do not fit the target type.
+uint64_t parse_unsigned(const std::string &arg, const std::string &name,
+                        uint64_t min_value, uint64_t max_value) {
+    size_t pos = 0;
+    uint64_t value = 0;
+    bool ok = !arg.empty() && arg.find_first_not_of("0123456789") == std::string::npos;
+    if (ok) {
+        try {
+            value = std::stoull(arg, &pos);
+        } catch (const std::out_of_range &) {
+            ok = false;
+        }
+    }
+    if (!ok || pos != arg.size() || value < min_value || value > max_value)
+        throw std::runtime_error(name + " khong hop le: " + arg + " (can so nguyen trong [" +
+                                 std::to_string(min_value) + ", " + std::to_string(max_value) + "])");
+    return value;
+}
+
+int main(int argc, char* argv[]) {
+    // Streaming mode: DFA_generator stream <num_states> <alphabet_size> <output> [json|bin] [seed]
+    if (argc > 1 && std::string(argv[1]) == "stream") {
+        if (argc < 5) {
+            std::cerr << "Usage: " << argv[0] << " stream <num_states> <alphabet_size> <output> [json|bin] [seed]" << std::endl;
+            return 1;
+        }
+        try {
+            uint32_t n = (uint32_t)parse_unsigned(argv[2], "num_states", 1, UINT32_MAX);
+            uint32_t alpha = (uint32_t)parse_unsigned(argv[3], "alphabet_size", 1, UINT32_MAX);
+            std::string output = argv[4];
+            std::string format = (argc > 5) ? argv[5] : "json";
+            if (format != "json" && format != "bin")
+                throw std::runtime_error("Dinh dang output khong hop le: " + format + " (json|bin)");
+            bool binary = (format == "bin");
+            uint64_t seed = (argc > 6) ? parse_unsigned(argv[6], "seed", 0, UINT64_MAX) : (uint64_t)std::time(nullptr);
+
+            std::cout << "Dang sinh (streaming) " << n << " states -> " << output << std::endl;
+            stream_random_dfa(output, n, alpha, binary, seed);
+            std::cout << "Hoan tat! (seed = " << seed << ")" << std::endl;
+        } catch (const std::exception &e) {
+            std::cerr << "ERROR: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
     // Config
     int base_states = 5; 
     int alphabet_size = 4;    // Num of char
@@ -149,6 +361,11 @@ int main() {
     min_file.close();
     std::cout << "-> Da luu: minimal_dfa.json" << std::endl;
 
+    // Ground truth of the base DFA (random DFA is not necessarily minimal)
+    std::vector<int> base_class;
+    int expected_min_states = compute_min_classes(minimal_dfa, base_class);
+    std::cout << "-> So trang thai toi thieu: " << expected_min_states << std::endl;
+
     // 2. Split into nonminimal DFA
     std::vector<int> targets = {1000, 10000, 50000};
     
@@ -162,14 +379,16 @@ int main() {
         // Start to split
         expand_dfa(expanded, target);
         
-        // Write into separate JSON file
+        // Write into separate JSON file (plain state array, readable by the solvers)
         std::string filename = std::to_string(target) + "_states_dfa.json";
         std::ofstream exp_file(filename);
-        exp_file << "{\n  \"expanded_dfa\": \n";
         write_single_dfa_json(exp_file, expanded, true);
-        exp_file << "}\n";
         exp_file.close();
         std::cout << "-> Da luu: " << filename << std::endl;
+
+        std::string truth_filename = std::to_string(target) + "_states_dfa.truth.json";
+        write_ground_truth_json(truth_filename, expanded, base_class, expected_min_states);
+        std::cout << "-> Da luu: " << truth_filename << std::endl;
     }
 
     std::cout << "Hoan tat!" << std::endl;
@@ -0,0 +1,111 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include <queue>
+#include <atomic>
+#include <functional>
+#include <iomanip>
+#include <chrono>
+#include <sstream>
+#include <windows.h>
+#include <psapi.h>
+#include <cstdint>
+#include "brzozowski.hpp" // Cấu trúc DFA dùng chung và lớp BrzozowskiSolver
+
+// === PHẦN 3: HÀM MAIN ===
+int main(int argc, char* argv[]) {
+    string inputFile = (argc > 1) ? argv[1] : "50000_states_dfa.json";
+    string outputFile = (argc > 2) ? argv[2] : "output.json";
+    string truthFile;
+    bool printHash = false;
+    double deadlineMs = 0; // 0 = không giới hạn
+    bool printProgress = false;
+    for (int i = 3; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--truth" && i + 1 < argc) truthFile = argv[++i];
+        else if (arg == "--hash") printHash = true;
+        else if (arg == "--deadline-ms" && i + 1 < argc) deadlineMs = stod(argv[++i]);
+        else if (arg == "--progress") printProgress = true;
+    }
+
+    try {
+        // Initialize CPU monitoring
+        getCPUUsage();
+        
+        // Load DFA
+        DFA myDFA = loadDFA_JSON(inputFile);
+        int initialStates = myDFA.states.size();
+        
+        // Extract test case label
+        string testCaseLabel = extractTestCaseLabel(inputFile);
+        
+        // Start timing and memory measurement
+        auto start = chrono::high_resolution_clock::now();
+        
+        // Run minimization (trên bảng chữ cái đã nén, sau khi gộp các hàng trùng nhau)
+        AlphabetClasses alphabetClasses;
+        DFA reducedDFA = compressAlphabet(myDFA, alphabetClasses);
+        RowMerge rowMerge;
+        DFA dedupDFA = mergeDuplicateRows(reducedDFA, rowMerge);
+        BrzozowskiSolver solver;
+        if (deadlineMs > 0)
+            solver.control.deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(deadlineMs * 1000));
+        if (printProgress) {
+            solver.control.on_progress = [](const SolverProgress& p) {
+                cerr << "Progress: rounds=" << p.rounds << " blocks=" << p.blocks
+                     << " marked_pairs=" << p.marked_pairs << " worklist=" << p.worklist << endl;
+            };
+        }
+        DFA minDFA = solver.minimize(dedupDFA);
+        minDFA = restoreMergedStates(minDFA, dedupDFA, reducedDFA, rowMerge);
+        minDFA = expandAlphabet(minDFA, alphabetClasses);
+        
+        // End timing and memory measurement
+        auto end = chrono::high_resolution_clock::now();
+        size_t memAfter = getCurrentMemoryUsage();
+        size_t peakMem = getPeakMemoryUsage();
+        double cpuUsage = getCPUUsage();
+        
+        // Calculate metrics
+        auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
+        double wallTimeMs = duration.count() / 1000.0;
+        int finalStates = minDFA.states.size();
+
+        // Đánh số lại theo BFS để kết quả không phụ thuộc thứ tự duyệt của solver
+        minDFA = canonicalizeDFA(minDFA);
+        size_t memoryUsage = memAfter;
+        
+        // Export result
+        exportDFA_JSON(minDFA, outputFile);
+        
+        // Display metrics in required format
+        cout << "Test_Case_Label: " << testCaseLabel << endl;
+        cout << "Initial_States: " << initialStates << endl;
+        cout << "Final_States: " << finalStates << endl;
+        cout << "Alphabet_Size: " << alphabetClasses.original_size << endl;
+        cout << "Alphabet_Classes: " << reducedDFA.alphabet.size() << endl;
+        cout << "Dedup_States: " << dedupDFA.states.size() << endl;
+        cout << "Dedup_Passes: " << rowMerge.passes << endl;
+        cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
+        cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << cpuUsage << endl;
+        cout << "Memory_Usage_KB: " << memoryUsage << endl;
+        cout << "Peak_Memory_KB: " << peakMem << endl;
+        if (!truthFile.empty())
+            cout << "Ground_Truth_Check: " << checkGroundTruth(minDFA, truthFile) << endl;
+        if (printHash)
+            cout << "Canonical_Hash: " << canonicalHash(minDFA) << endl;
+        
+    } catch (const SolverCancelled& e) {
+        cerr << "CANCELLED: " << e.what() << endl;
+        return 3;
+    } catch (const exception& e) {
+        cerr << "ERROR: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,319 @@
+// Brzozowski: lớp BrzozowskiSolver.
+// Dùng chung giữa brzozowski.cpp (main riêng) và portfolio.cpp.
+#ifndef BRZOZOWSKI_HPP
+#define BRZOZOWSKI_HPP
+
+#include "dfa_core.hpp"
+
+// === PHẦN 2: LOGIC BRZOZOWSKI ===
+// minimal(A) = det(rev(det(rev(A))))
+// Automaton phẳng dùng nội bộ: trans[u * k + c] = v, -1 nếu không có cạnh
+struct FlatDFA {
+    int n = 0, k = 0;
+    int start = -1;
+    vector<int> trans;
+    vector<char> is_final;
+};
+
+// Tập con trạng thái dạng bit-packed, lưu liên tiếp trong một arena:
+// tập thứ i nằm ở arena[i * words, (i + 1) * words)
+class SubsetArena {
+private:
+    size_t words;
+    vector<uint64_t> arena;
+    vector<int> table; // Bảng băm địa chỉ mở: id tập con, -1 = trống
+    int count = 0;
+
+    static uint64_t hashWords(const uint64_t* w, size_t len) {
+        uint64_t h = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < len; ++i) {
+            h ^= w[i] + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+            h *= 0xBF58476D1CE4E5B9ULL;
+        }
+        return h ^ (h >> 31);
+    }
+    bool equalAt(int id, const uint64_t* w) const {
+        return equal(w, w + words, arena.begin() + (size_t)id * words);
+    }
+    void grow() {
+        vector<int> old;
+        old.swap(table);
+        table.assign(old.size() * 2, -1);
+        size_t mask = table.size() - 1;
+        for (int id : old) {
+            if (id < 0) continue;
+            size_t pos = hashWords(get(id), words) & mask;
+            while (table[pos] != -1) pos = (pos + 1) & mask;
+            table[pos] = id;
+        }
+    }
+
+public:
+    explicit SubsetArena(int n) : words((n + 63) / 64), table(1024, -1) {}
+
+    size_t wordCount() const { return words; }
+    int size() const { return count; }
+    size_t bytes() const { return arena.capacity() * sizeof(uint64_t) + table.capacity() * sizeof(int); }
+    const uint64_t* get(int id) const { return arena.data() + (size_t)id * words; }
+
+    // Trả về id của tập con; thêm mới nếu chưa có (isNew = true)
+    int findOrInsert(const uint64_t* w, bool& isNew) {
+        if ((size_t)(count + 1) * 2 > table.size()) grow();
+        size_t mask = table.size() - 1;
+        size_t pos = hashWords(w, words) & mask;
+        while (table[pos] != -1) {
+            if (equalAt(table[pos], w)) { isNew = false; return table[pos]; }
+            pos = (pos + 1) & mask;
+        }
+        arena.insert(arena.end(), w, w + words);
+        table[pos] = count;
+        isNew = true;
+        return count++;
+    }
+};
+
+class BrzozowskiSolver {
+private:
+    DFA removeUnreachable(const DFA& dfa) {
+        DFA clean = dfa; 
+        set<int> reachable; queue<int> q;
+        if (dfa.start_state == -1) return clean; 
+        q.push(dfa.start_state); reachable.insert(dfa.start_state);
+        while(!q.empty()) {
+            int u = q.front(); q.pop();
+            if (dfa.transitions.count(u)) {
+                for (auto const& p : dfa.transitions.at(u)) {
+                    if (!reachable.count(p.second)) {
+                        reachable.insert(p.second); q.push(p.second);
+                    }
+                }
+            }
+        }
+        clean.states = reachable;
+        set<int> new_finals;
+        for(int s : reachable) if(dfa.final_states.count(s)) new_finals.insert(s);
+        clean.final_states = new_finals;
+        return clean;
+    }
+
+    // Hàm tái tạo DFA dùng chung logic tái tạo nhóm
+    DFA reconstructDFA(const DFA& oldDFA, const vector<int>& group_id) {
+        DFA newDFA;
+        newDFA.input_char_to_id = oldDFA.input_char_to_id;
+        newDFA.input_id_to_char = oldDFA.input_id_to_char;
+        newDFA.alphabet = oldDFA.alphabet;
+
+        map<int, vector<int>> groups;
+        for(int u : oldDFA.states) groups[group_id[u]].push_back(u);
+
+        map<int, string> new_group_names;
+
+        for(auto const& pair : groups) {
+            int g_id = pair.first;
+            string name = "{";
+            vector<string> names;
+            bool is_s = false, is_f = false;
+            auto cls = oldDFA.accept_class.end(); // Mọi trạng thái trong nhóm cùng nhãn
+            for(int u : pair.second) {
+                names.push_back(oldDFA.state_id_to_name.at(u));
+                if(u == oldDFA.start_state) is_s = true;
+                if(oldDFA.final_states.count(u)) is_f = true;
+                if(oldDFA.accept_class.count(u)) cls = oldDFA.accept_class.find(u);
+            }
+            sort(names.begin(), names.end());
+            for(size_t i=0; i<names.size(); ++i) name += (i==0?"":",") + names[i];
+            name += "}";
+
+            newDFA.getStateID(name);
+            if(is_s) newDFA.setStart(name);
+            if(is_f) newDFA.addFinal(name);
+            if(cls != oldDFA.accept_class.end()) newDFA.setAcceptClass(name, cls->second);
+            new_group_names[g_id] = name;
+        }
+
+        for(auto const& pair : groups) {
+            int g_id = pair.first;
+            int rep = pair.second[0];
+            string src_name = new_group_names[g_id];
+            if(oldDFA.transitions.count(rep)) {
+                for(auto const& t : oldDFA.transitions.at(rep)) {
+                    newDFA.addTransition(src_name, newDFA.input_id_to_char[t.first], new_group_names[group_id[t.second]]);
+                }
+            }
+            if(oldDFA.transition_output.count(rep)) {
+                for(auto const& o : oldDFA.transition_output.at(rep))
+                    newDFA.setOutput(src_name, newDFA.input_id_to_char[o.first], o.second);
+            }
+        }
+        return newDFA;
+    }
+
+    // det(rev(A)): trạng thái mới là tập con các trạng thái của A, duyệt theo BFS
+    // (id tăng dần theo thứ tự phát hiện). Tập rỗng không được tạo ra.
+    FlatDFA determinizeReverse(const FlatDFA& A) {
+        int n = A.n, k = A.k;
+        FlatDFA D;
+        D.k = k;
+
+        // Chỉ mục ngược dạng CSR: pred[offset[v*k+c] .. offset[v*k+c+1]) = {u : A(u, c) = v}
+        vector<int> offset((size_t)n * k + 1, 0);
+        for (size_t i = 0; i < A.trans.size(); ++i)
+            if (A.trans[i] != -1) offset[(size_t)A.trans[i] * k + i % k + 1]++;
+        for (size_t i = 1; i < offset.size(); ++i) offset[i] += offset[i - 1];
+        vector<int> pred(offset.back());
+        vector<int> fill(offset.begin(), offset.end() - 1);
+        for (size_t i = 0; i < A.trans.size(); ++i)
+            if (A.trans[i] != -1) pred[fill[(size_t)A.trans[i] * k + i % k]++] = i / k;
+
+        SubsetArena subsets(n);
+        size_t words = subsets.wordCount();
+        vector<uint64_t> scratch(words, 0);
+
+        // Trạng thái bắt đầu của rev(A) = tập trạng thái kết thúc của A
+        bool any = false, isNew;
+        for (int u = 0; u < n; ++u)
+            if (A.is_final[u]) { scratch[u >> 6] |= 1ULL << (u & 63); any = true; }
+        if (!any) return D;
+        D.start = subsets.findOrInsert(scratch.data(), isNew);
+
+        SolverProgress progress;
+        for (int id = 0; id < subsets.size(); ++id) {
+            progress.blocks = subsets.size();
+            progress.rounds = id;
+            progress.worklist = subsets.size() - id;
+            control.poll(progress);
+            if (memory_budget_bytes && subsets.bytes() > memory_budget_bytes)
+                throw runtime_error("Brzozowski: tap con vuot ngan sach bo nho");
+            // Trạng thái kết thúc của rev(A) = trạng thái bắt đầu của A
+            D.is_final.push_back((subsets.get(id)[A.start >> 6] >> (A.start & 63)) & 1);
+            for (int c = 0; c < k; ++c) {
+                std::fill(scratch.begin(), scratch.end(), 0);
+                any = false;
+                const uint64_t* S = subsets.get(id); // arena có thể cấp phát lại sau findOrInsert
+                for (size_t w = 0; w < words; ++w) {
+                    uint64_t bits = S[w];
+                    while (bits) {
+                        int v = (int)(w * 64 + __builtin_ctzll(bits));
+                        bits &= bits - 1;
+                        for (int p = offset[(size_t)v * k + c]; p < offset[(size_t)v * k + c + 1]; ++p) {
+                            scratch[pred[p] >> 6] |= 1ULL << (pred[p] & 63);
+                            any = true;
+                        }
+                    }
+                }
+                D.trans.push_back(any ? subsets.findOrInsert(scratch.data(), isNew) : -1);
+            }
+        }
+        D.n = subsets.size();
+        return D;
+    }
+
+    // Gán mỗi trạng thái của dfa vào trạng thái của M bằng BFS song song trên dfa và M.
+    // M không có trạng thái chết: trạng thái không dẫn tới trạng thái kết thúc
+    // được gom vào nhóm M.n.
+    vector<int> groupByMinimal(DFA& dfa, const FlatDFA& M) {
+        int dead = M.n;
+        vector<int> group(dfa.state_counter, -1);
+        queue<int> q;
+        group[dfa.start_state] = (M.start == -1) ? dead : M.start;
+        q.push(dfa.start_state);
+        while (!q.empty()) {
+            int u = q.front(); q.pop();
+            for (auto const& t : dfa.transitions[u]) {
+                if (group[t.second] != -1) continue;
+                int g = group[u];
+                group[t.second] = (g == dead || M.trans[(size_t)g * M.k + t.first] == -1)
+                                  ? dead : M.trans[(size_t)g * M.k + t.first];
+                q.push(t.second);
+            }
+        }
+        return group;
+    }
+
+    // Brzozowski cho tương đương ngôn ngữ: mọi trạng thái chết chung một nhóm và cạnh
+    // tới trạng thái chết không khác thiếu cạnh. Các engine khác coi thiếu cạnh khác cạnh
+    // (DFA bộ phận), nên tinh chỉnh tiếp kiểu Moore với chữ ký (nhóm, nhóm đích hoặc -1
+    // theo từng symbol) tới điểm bất động: kết quả là phân hoạch thô nhất ổn định mịn hơn
+    // nhóm của Brzozowski, tức đúng phân hoạch của Hopcroft / Moore / Table Filling.
+    void refineByEdges(const DFA& dfa, vector<int>& group) {
+        int k = dfa.input_counter;
+        set<int> initial;
+        for (int u : dfa.states) initial.insert(group[u]);
+        size_t count = initial.size();
+        SolverProgress progress;
+        vector<int> sig(k + 1);
+        while (true) {
+            progress.blocks = count;
+            control.poll(progress);
+            progress.rounds++;
+            map<vector<int>, int> ids;
+            vector<int> next(group.size(), -1);
+            for (int u : dfa.states) {
+                sig[0] = group[u];
+                for (int c = 0; c < k; ++c) sig[c + 1] = -1;
+                auto it = dfa.transitions.find(u);
+                if (it != dfa.transitions.end())
+                    for (auto const& t : it->second) sig[t.first + 1] = group[t.second];
+                next[u] = ids.emplace(sig, (int)ids.size()).first->second;
+            }
+            group.swap(next);
+            if (ids.size() == count) return;
+            count = ids.size();
+        }
+    }
+
+public:
+    // Hủy / deadline / tiến độ, được kiểm tra ở ranh giới mỗi vòng tinh chỉnh
+    SolverControl control;
+    // Giới hạn bộ nhớ cho các tập con (0 = không giới hạn)
+    size_t memory_budget_bytes = 0;
+
+    DFA minimize(DFA inputDFA) {
+        DFA dfa = removeUnreachable(inputDFA);
+        if (dfa.states.empty()) return dfa;
+
+        // 1. Chuyển sang dạng phẳng (đánh số lại các trạng thái đạt được)
+        vector<int> flat_id(dfa.state_counter, -1);
+        FlatDFA A;
+        A.k = dfa.input_counter;
+        for (int u : dfa.states) flat_id[u] = A.n++;
+        A.trans.assign((size_t)A.n * A.k, -1);
+        A.start = flat_id[dfa.start_state];
+        for (int u : dfa.states)
+            for (auto const& t : dfa.transitions[u]) A.trans[(size_t)flat_id[u] * A.k + t.first] = flat_id[t.second];
+
+        // Nhãn đầu ra nhiều lớp (accept_class, output Mealy): mã hóa nhãn thành bit, mã 0 =
+        // không kết thúc, không nhãn, không output (giống trạng thái thiếu cạnh). Hai trạng
+        // thái tương đương khi tương đương trên DFA "bit b" với mọi b, nên chỉ cần
+        // ceil(log2(số nhãn)) lần Brzozowski thay vì một lần cho mỗi nhãn. DFA thường: một lần.
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        bool has_plain = false;
+        for (int u : dfa.states)
+            if (outputKey(dfa, u) == OutputKey()) has_plain = true;
+        int shift = has_plain ? 0 : 1, bits = 1;
+        while ((1 << bits) < num_labels + shift) bits++;
+
+        vector<int> group;
+        for (int b = 0; b < bits; ++b) {
+            A.is_final.assign(A.n, 0);
+            for (int u : dfa.states) A.is_final[flat_id[u]] = ((label[u] + shift) >> b) & 1;
+
+            // 2. Đảo - tất định hóa - đảo - tất định hóa
+            FlatDFA M = determinizeReverse(determinizeReverse(A));
+
+            // 3. Gán mỗi trạng thái cũ vào trạng thái của M, giao với các bit trước đó
+            vector<int> bit_group = groupByMinimal(dfa, M);
+            if (b == 0) { group.swap(bit_group); continue; }
+            map<pair<int, int>, int> combined;
+            for (int u : dfa.states)
+                group[u] = combined.emplace(make_pair(group[u], bit_group[u]), (int)combined.size()).first->second;
+        }
+
+        // 4. Tách nhóm theo cạnh có / thiếu như các engine khác, rồi tái tạo DFA
+        refineByEdges(dfa, group);
+        return reconstructDFA(dfa, group);
+    }
+};
+
+#endif // BRZOZOWSKI_HPP
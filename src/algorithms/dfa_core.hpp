@@ -0,0 +1,669 @@
+// Phần dùng chung của mọi solver (hopcroft, moore, table_filling, brzozowski, portfolio):
+// cấu trúc DFA, đọc/ghi JSON, nhãn đầu ra, nén bảng chữ cái, gộp hàng trùng, chuẩn hóa và
+// hash, điều khiển hủy / tiến độ, đo metrics và kiểm tra ground truth.
+#ifndef DFA_CORE_HPP
+#define DFA_CORE_HPP
+
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+#include <tuple>
+#include <algorithm>
+#include <queue>
+#include <atomic>
+#include <functional>
+#include <iomanip>
+#include <chrono>
+#include <sstream>
+#include <windows.h>
+#include <psapi.h>
+#include <cstdint>
+#include "json.hpp" // File json.hpp phải nằm cùng thư mục
+
+using json = nlohmann::json;
+using namespace std;
+
+// === CẤU TRÚC DFA ===
+// Ném ra khi solver bị hủy giữa chừng (token hủy được bật hoặc quá deadline)
+struct SolverCancelled : runtime_error {
+    explicit SolverCancelled(const string& reason) : runtime_error(reason) {}
+};
+
+// Tiến độ của solver, báo tại ranh giới mỗi vòng tinh chỉnh
+struct SolverProgress {
+    long long blocks = 0;       // Số khối (lớp) hiện có
+    long long rounds = 0;       // Số vòng / splitter đã xử lý
+    long long marked_pairs = 0; // Table filling: số cặp đã đánh dấu
+    long long worklist = 0;     // Số phần tử còn chờ xử lý (W của Hopcroft, tập con của Brzozowski)
+};
+
+// Điều khiển hợp tác cho Solver::minimize: token hủy, deadline và callback tiến độ
+struct SolverControl {
+    const atomic<bool>* cancel_flag = nullptr;
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::time_point::max();
+    function<void(const SolverProgress&)> on_progress;
+    chrono::milliseconds progress_interval{200}; // Khoảng cách tối thiểu giữa hai lần báo
+
+    // Gọi tại ranh giới vòng lặp: ném SolverCancelled nếu phải dừng
+    void poll(const SolverProgress& progress) {
+        if (cancel_flag && cancel_flag->load(memory_order_relaxed)) throw SolverCancelled("Solver da bi huy");
+        auto now = chrono::steady_clock::now();
+        if (now > deadline) throw SolverCancelled("Solver vuot qua deadline");
+        if (on_progress && now - last_report >= progress_interval) {
+            last_report = now;
+            on_progress(progress);
+        }
+    }
+
+private:
+    chrono::steady_clock::time_point last_report{};
+};
+
+struct DFA {
+    set<int> states;
+    set<int> alphabet;
+    map<int, map<int, int>> transitions;
+    int start_state = -1;
+    set<int> final_states;
+    // Nhãn đầu ra (token của lexer, output của máy Moore); trạng thái không có nhãn
+    // chỉ được phân biệt theo final_states
+    map<int, string> accept_class;
+    // Máy Mealy / transducer: output của cạnh (u, c); cạnh không có output thì không lưu
+    map<int, map<int, string>> transition_output;
+    
+    // Mapping tên <-> ID
+    map<int, string> state_id_to_name;
+    map<string, int> state_name_to_id;
+    map<int, string> input_id_to_char;
+    map<string, int> input_char_to_id;
+    int state_counter = 0;
+    int input_counter = 0;
+
+    int getStateID(string name) {
+        if (state_name_to_id.find(name) == state_name_to_id.end()) {
+            state_name_to_id[name] = state_counter;
+            state_id_to_name[state_counter] = name;
+            states.insert(state_counter);
+            state_counter++;
+        }
+        return state_name_to_id[name];
+    }
+    int getInputID(string char_str) {
+        if (input_char_to_id.find(char_str) == input_char_to_id.end()) {
+            input_char_to_id[char_str] = input_counter;
+            input_id_to_char[input_counter] = char_str;
+            alphabet.insert(input_counter);
+            input_counter++;
+        }
+        return input_char_to_id[char_str];
+    }
+    void addTransition(string from, string input_char, string to) {
+        int u = getStateID(from);
+        int v = getStateID(to);
+        int c = getInputID(input_char);
+        transitions[u][c] = v;
+    }
+    void setStart(string name) { start_state = getStateID(name); }
+    void addFinal(string name) { final_states.insert(getStateID(name)); }
+    void setAcceptClass(string name, string cls) { accept_class[getStateID(name)] = cls; }
+    void setOutput(string from, string input_char, string output) {
+        transition_output[getStateID(from)][getInputID(input_char)] = output;
+    }
+};
+
+// Hàm đọc/ghi JSON
+inline DFA loadDFA_JSON(string filename) {
+    ifstream f(filename);
+    if (!f.is_open()) throw runtime_error("Khong mo duoc file input: " + filename);
+    json j; f >> j;
+    DFA dfa;
+    for (auto& item : j) {
+        string s = item["state_name"];
+        dfa.getStateID(s);
+        if (item.value("is_start", false)) dfa.setStart(s);
+        if (item.value("is_end", false)) dfa.addFinal(s);
+        if (item.contains("accept_class")) dfa.setAcceptClass(s, item["accept_class"]);
+        if (item.contains("transitions")) {
+            for (auto& t : item["transitions"]) {
+                // addTransition ghi đè cạnh cũ: NFA phải báo lỗi thay vì mất cạnh
+                auto row = dfa.transitions.find(dfa.getStateID(s));
+                auto c = dfa.input_char_to_id.find(t["input"]);
+                if (row != dfa.transitions.end() && c != dfa.input_char_to_id.end() && row->second.count(c->second) &&
+                    dfa.state_id_to_name.at(row->second.at(c->second)) != t["target_state"])
+                    throw runtime_error("Input khong tat dinh: trang thai " + s + " co nhieu canh '" +
+                                        t["input"].get<string>() + "' (dung hopcroft --nfa)");
+                dfa.addTransition(s, t["input"], t["target_state"]);
+                if (t.contains("output")) dfa.setOutput(s, t["input"], t["output"]);
+            }
+        }
+    }
+    return dfa;
+}
+
+inline void exportDFA_JSON(const DFA& dfa, string filename) {
+    json j_out = json::array();
+    for (int u : dfa.states) {
+        json j_s;
+        j_s["state_name"] = dfa.state_id_to_name.at(u);
+        j_s["is_start"] = (u == dfa.start_state);
+        j_s["is_end"] = (dfa.final_states.count(u) > 0);
+        if (dfa.accept_class.count(u)) j_s["accept_class"] = dfa.accept_class.at(u);
+        json j_trans = json::array();
+        auto out = dfa.transition_output.find(u);
+        if (dfa.transitions.count(u)) {
+            for (auto const& p : dfa.transitions.at(u)) {
+                json t;
+                t["input"] = dfa.input_id_to_char.at(p.first);
+                t["target_state"] = dfa.state_id_to_name.at(p.second);
+                if (out != dfa.transition_output.end() && out->second.count(p.first))
+                    t["output"] = out->second.at(p.first);
+                j_trans.push_back(t);
+            }
+        }
+        j_s["transitions"] = j_trans;
+        j_out.push_back(j_s);
+    }
+    ofstream o(filename); o << std::setw(4) << j_out;
+}
+
+// Khóa đầu ra của trạng thái: (is_end, accept_class, output của các cạnh ra theo symbol).
+// Với máy Mealy, hai trạng thái tương đương khi cùng khóa và cùng khối đích trên mọi
+// symbol, nên output chỉ làm mịn phân hoạch khởi tạo; bảng chữ cái không đổi.
+typedef tuple<bool, string, vector<pair<int, string>>> OutputKey;
+
+inline OutputKey outputKey(const DFA& dfa, int u) {
+    OutputKey key;
+    get<0>(key) = dfa.final_states.count(u) > 0;
+    auto ac = dfa.accept_class.find(u);
+    if (ac != dfa.accept_class.end()) get<1>(key) = ac->second;
+    auto out = dfa.transition_output.find(u);
+    if (out != dfa.transition_output.end())
+        get<2>(key).assign(out->second.begin(), out->second.end());
+    return key;
+}
+
+// Nhãn khởi tạo phân hoạch của mọi engine: khóa đầu ra đánh số theo thứ tự tăng dần trên
+// các trạng thái của dfa.states, nên OutputKey() (không kết thúc, không nhãn, không output)
+// luôn là nhãn 0 nếu có. DFA không dùng accept_class / output cho đúng {Q \ F, F}.
+inline vector<int> outputLabels(const DFA& dfa, int& num_labels) {
+    map<OutputKey, int> ids;
+    for (int u : dfa.states) ids[outputKey(dfa, u)] = 0;
+    num_labels = 0;
+    for (auto& p : ids) p.second = num_labels++;
+    vector<int> label(dfa.state_counter, -1);
+    for (int u : dfa.states) label[u] = ids[outputKey(dfa, u)];
+    return label;
+}
+
+// Nén bảng chữ cái: gộp các symbol có cột chuyển giống hệt nhau trên mọi trạng thái
+// thành một lớp. Solver chỉ chạy trên symbol đại diện của mỗi lớp, sau đó
+// expandAlphabet trả lại các cạnh cho toàn bộ symbol trong lớp.
+struct AlphabetClasses {
+    int original_size = 0;
+    map<string, vector<string>> members; // symbol đại diện -> các symbol khác cùng lớp
+};
+
+inline DFA compressAlphabet(const DFA& dfa, AlphabetClasses& classes) {
+    classes.original_size = dfa.alphabet.size();
+    classes.members.clear();
+
+    // Hash cột của mỗi symbol: tổng (không phụ thuộc thứ tự) của hash từng cặp (u, đích)
+    vector<uint64_t> col_hash(dfa.input_counter, 0);
+    for (auto const& row : dfa.transitions) {
+        for (auto const& t : row.second) {
+            uint64_t x = ((uint64_t)row.first << 32) ^ (uint32_t)t.second;
+            x ^= x >> 33; x *= 0xff51afd7ed558ccdULL; x ^= x >> 33;
+            col_hash[t.first] += x;
+        }
+    }
+    auto sameColumn = [&](int c, int d) {
+        for (auto const& row : dfa.transitions) {
+            auto tc = row.second.find(c), td = row.second.find(d);
+            int vc = (tc == row.second.end()) ? -1 : tc->second;
+            int vd = (td == row.second.end()) ? -1 : td->second;
+            if (vc != vd) return false;
+        }
+        for (auto const& row : dfa.transition_output) {
+            auto oc = row.second.find(c), od = row.second.find(d);
+            if ((oc == row.second.end()) != (od == row.second.end())) return false;
+            if (oc != row.second.end() && oc->second != od->second) return false;
+        }
+        return true;
+    };
+
+    // Duyệt symbol theo thứ tự chuỗi: đại diện là symbol nhỏ nhất của lớp
+    map<uint64_t, vector<int>> reps_by_hash;
+    vector<int> rep_of(dfa.input_counter, -1);
+    vector<int> reps;
+    for (auto const& p : dfa.input_char_to_id) {
+        int c = p.second;
+        for (int r : reps_by_hash[col_hash[c]]) {
+            if (sameColumn(c, r)) { rep_of[c] = r; break; }
+        }
+        if (rep_of[c] == -1) {
+            rep_of[c] = c;
+            reps.push_back(c);
+            reps_by_hash[col_hash[c]].push_back(c);
+            classes.members[p.first];
+        } else {
+            classes.members[dfa.input_id_to_char.at(rep_of[c])].push_back(p.first);
+        }
+    }
+    if (reps.size() == dfa.alphabet.size()) return dfa;
+
+    DFA reduced = dfa;
+    reduced.transitions.clear();
+    reduced.transition_output.clear();
+    reduced.alphabet.clear();
+    reduced.input_id_to_char.clear();
+    reduced.input_char_to_id.clear();
+    reduced.input_counter = 0;
+    vector<int> new_id(dfa.input_counter, -1);
+    for (int r : reps) new_id[r] = reduced.getInputID(dfa.input_id_to_char.at(r));
+    for (auto const& row : dfa.transitions)
+        for (auto const& t : row.second)
+            if (rep_of[t.first] == t.first) reduced.transitions[row.first][new_id[t.first]] = t.second;
+    for (auto const& row : dfa.transition_output)
+        for (auto const& o : row.second)
+            if (rep_of[o.first] == o.first) reduced.transition_output[row.first][new_id[o.first]] = o.second;
+    return reduced;
+}
+
+inline DFA expandAlphabet(const DFA& dfa, const AlphabetClasses& classes) {
+    DFA full = dfa;
+    // Các hàm tái tạo chỉ chép bảng input, không chép input_counter
+    if (!full.input_id_to_char.empty())
+        full.input_counter = max(full.input_counter, full.input_id_to_char.rbegin()->first + 1);
+    for (auto const& cls : classes.members) {
+        if (cls.second.empty() || !dfa.input_char_to_id.count(cls.first)) continue;
+        int rep = dfa.input_char_to_id.at(cls.first);
+        vector<int> ids;
+        for (const string& s : cls.second) ids.push_back(full.getInputID(s));
+        for (auto& row : full.transitions) {
+            auto t = row.second.find(rep);
+            if (t == row.second.end()) continue;
+            int target = t->second;
+            for (int id : ids) row.second[id] = target;
+        }
+        for (auto& row : full.transition_output) {
+            auto o = row.second.find(rep);
+            if (o == row.second.end()) continue;
+            string output = o->second;
+            for (int id : ids) row.second[id] = output;
+        }
+    }
+    return full;
+}
+
+// Gộp trạng thái có hàng chuyển trùng nhau (cùng nhãn đầu ra, cùng đích trên mọi input),
+// lặp lại cho tới điểm bất động. Mỗi lượt O(n * |Σ|) với bảng băm phẳng. Chỉ xét các
+// trạng thái đạt được; kết quả không chứa trạng thái không đạt được.
+struct RowMerge {
+    int original_states = 0;
+    int passes = 0;
+    map<int, vector<int>> merged; // trạng thái đại diện -> các trạng thái đã gộp vào nó
+};
+
+inline DFA mergeDuplicateRows(const DFA& dfa, RowMerge& merge) {
+    merge.original_states = dfa.states.size();
+    merge.passes = 0;
+    merge.merged.clear();
+    if (dfa.start_state == -1) return dfa;
+
+    int n = dfa.state_counter, k = dfa.input_counter;
+    vector<int> flat((size_t)n * k, -1);
+    vector<int> live;
+    vector<char> seen(n, 0);
+    live.push_back(dfa.start_state); seen[dfa.start_state] = 1;
+    for (size_t i = 0; i < live.size(); ++i) {
+        auto it = dfa.transitions.find(live[i]);
+        if (it == dfa.transitions.end()) continue;
+        for (auto const& t : it->second) {
+            flat[(size_t)live[i] * k + t.first] = t.second;
+            if (!seen[t.second]) { seen[t.second] = 1; live.push_back(t.second); }
+        }
+    }
+    sort(live.begin(), live.end());
+
+    vector<int> rep(n);
+    for (int u = 0; u < n; ++u) rep[u] = u;
+    auto find = [&](int u) {
+        while (rep[u] != u) { rep[u] = rep[rep[u]]; u = rep[u]; }
+        return u;
+    };
+    vector<char> is_final(n, 0);
+    for (int u : dfa.final_states) is_final[u] = 1;
+    int num_labels;
+    vector<int> label = outputLabels(dfa, num_labels);
+
+    auto rowHash = [&](int u) {
+        uint64_t h = 0x632be59bd9b4e019ULL + (uint64_t)label[u] * 0x9e3779b97f4a7c15ULL;
+        for (int c = 0; c < k; ++c) {
+            int v = flat[(size_t)u * k + c];
+            h = (h ^ (uint64_t)(int64_t)(v == -1 ? -1 : find(v))) * 0xff51afd7ed558ccdULL;
+            h ^= h >> 29;
+        }
+        return h;
+    };
+    auto sameRow = [&](int u, int w) {
+        if (label[u] != label[w]) return false;
+        for (int c = 0; c < k; ++c) {
+            int a = flat[(size_t)u * k + c], b = flat[(size_t)w * k + c];
+            if ((a == -1 ? -1 : find(a)) != (b == -1 ? -1 : find(b))) return false;
+        }
+        return true;
+    };
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        merge.passes++;
+        size_t cap = 1;
+        while (cap < live.size() * 2) cap <<= 1;
+        vector<int> table(cap, -1);
+        vector<int> next_live;
+        for (int u : live) {
+            size_t pos = rowHash(u) & (cap - 1);
+            while (table[pos] != -1 && !sameRow(u, table[pos])) pos = (pos + 1) & (cap - 1);
+            if (table[pos] == -1) { table[pos] = u; next_live.push_back(u); }
+            else { rep[u] = table[pos]; changed = true; }
+        }
+        live.swap(next_live);
+    }
+
+    DFA reduced = dfa;
+    reduced.states = set<int>(live.begin(), live.end());
+    reduced.transitions.clear();
+    reduced.final_states.clear();
+    reduced.accept_class.clear();
+    reduced.transition_output.clear();
+    for (int u : live) {
+        if (is_final[u]) reduced.final_states.insert(u);
+        auto ac = dfa.accept_class.find(u);
+        if (ac != dfa.accept_class.end()) reduced.accept_class[u] = ac->second;
+        auto out = dfa.transition_output.find(u);
+        if (out != dfa.transition_output.end()) reduced.transition_output[u] = out->second;
+        for (int c = 0; c < k; ++c) {
+            int v = flat[(size_t)u * k + c];
+            if (v != -1) reduced.transitions[u][c] = find(v);
+        }
+    }
+    for (int u = 0; u < n; ++u)
+        if (seen[u] && find(u) != u) merge.merged[find(u)].push_back(u);
+    return reduced;
+}
+
+// Trả lại tên đầy đủ cho kết quả: mỗi trạng thái của minDFA được ghép với các trạng
+// thái của reduced bằng BFS song song, rồi đặt tên theo toàn bộ trạng thái gốc.
+inline DFA restoreMergedStates(const DFA& minDFA, const DFA& reduced, const DFA& original, const RowMerge& merge) {
+    if (merge.merged.empty() || minDFA.start_state == -1) return minDFA;
+
+    map<int, vector<string>> members; // trạng thái của minDFA -> tên các trạng thái gốc
+    map<int, int> owner;              // trạng thái của reduced -> trạng thái của minDFA
+    queue<int> q;
+    owner[reduced.start_state] = minDFA.start_state;
+    q.push(reduced.start_state);
+    while (!q.empty()) {
+        int u = q.front(); q.pop();
+        int m = owner[u];
+        members[m].push_back(original.state_id_to_name.at(u));
+        auto mg = merge.merged.find(u);
+        if (mg != merge.merged.end())
+            for (int w : mg->second) members[m].push_back(original.state_id_to_name.at(w));
+        auto it = reduced.transitions.find(u);
+        if (it == reduced.transitions.end()) continue;
+        // Engine cắt trạng thái chết có thể không giữ cạnh tương ứng: đích không thuộc
+        // trạng thái nào của minDFA thì bỏ qua thay vì gọi .at()
+        auto row = minDFA.transitions.find(m);
+        for (auto const& t : it->second) {
+            if (owner.count(t.second)) continue;
+            if (row == minDFA.transitions.end()) continue;
+            auto e = row->second.find(t.first);
+            if (e == row->second.end()) continue;
+            owner[t.second] = e->second;
+            q.push(t.second);
+        }
+    }
+
+    DFA named = minDFA;
+    named.state_id_to_name.clear();
+    named.state_name_to_id.clear();
+    for (int m : minDFA.states) {
+        vector<string>& names = members[m];
+        sort(names.begin(), names.end());
+        string name = "{";
+        for (size_t i = 0; i < names.size(); ++i) name += (i == 0 ? "" : ",") + names[i];
+        name += "}";
+        named.state_id_to_name[m] = name;
+        named.state_name_to_id[name] = m;
+    }
+    return named;
+}
+
+// Chuẩn hóa đầu ra: đánh số lại trạng thái theo BFS từ trạng thái bắt đầu, duyệt
+// symbol theo thứ tự chuỗi. Hai DFA đẳng cấu luôn cho cùng một kết quả (cùng thứ tự
+// trạng thái và thứ tự input), bất kể solver nào sinh ra.
+inline DFA canonicalizeDFA(const DFA& dfa) {
+    DFA canon;
+    vector<int> sorted_inputs; // input id cũ, theo thứ tự chuỗi
+    for (auto const& p : dfa.input_char_to_id) {
+        canon.getInputID(p.first);
+        sorted_inputs.push_back(p.second);
+    }
+
+    vector<int> order;
+    set<int> visited;
+    if (dfa.start_state != -1 && dfa.states.count(dfa.start_state)) {
+        order.push_back(dfa.start_state);
+        visited.insert(dfa.start_state);
+    }
+    for (size_t i = 0; i < order.size(); ++i) {
+        auto it = dfa.transitions.find(order[i]);
+        if (it == dfa.transitions.end()) continue;
+        for (int c : sorted_inputs) {
+            auto t = it->second.find(c);
+            if (t != it->second.end() && visited.insert(t->second).second) order.push_back(t->second);
+        }
+    }
+    for (int u : dfa.states) if (!visited.count(u)) order.push_back(u); // Không đạt được: giữ thứ tự cũ
+
+    for (int u : order) canon.getStateID(dfa.state_id_to_name.at(u));
+    if (dfa.start_state != -1) canon.setStart(dfa.state_id_to_name.at(dfa.start_state));
+    for (int u : order) {
+        const string& name = dfa.state_id_to_name.at(u);
+        if (dfa.final_states.count(u)) canon.addFinal(name);
+        auto ac = dfa.accept_class.find(u);
+        if (ac != dfa.accept_class.end()) canon.setAcceptClass(name, ac->second);
+        auto it = dfa.transitions.find(u);
+        if (it == dfa.transitions.end()) continue;
+        auto out = dfa.transition_output.find(u);
+        for (int c : sorted_inputs) {
+            auto t = it->second.find(c);
+            if (t == it->second.end()) continue;
+            canon.addTransition(name, dfa.input_id_to_char.at(c), dfa.state_id_to_name.at(t->second));
+            if (out != dfa.transition_output.end() && out->second.count(c))
+                canon.setOutput(name, dfa.input_id_to_char.at(c), out->second.at(c));
+        }
+    }
+    return canon;
+}
+
+// Hash 128-bit của DFA đã chuẩn hóa: chỉ phụ thuộc cấu trúc (số trạng thái, các ký tự có cạnh,
+// trạng thái kết thúc, nhãn, bảng chuyển, output), không phụ thuộc tên trạng thái.
+// Ký tự không có cạnh nào bị bỏ qua để cùng một JSON luôn cho cùng hash; mỗi trường
+// tùy chọn (accept_class, output) có thẻ 0/1 đứng trước nên luồng băm không nhập nhằng.
+inline string canonicalHash(const DFA& canon) {
+    uint64_t h1 = 0x6a09e667f3bcc908ULL, h2 = 0xbb67ae8584caa73bULL;
+    auto mix = [](uint64_t x) {
+        x ^= x >> 33; x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33; x *= 0xc4ceb9fe1a85ec53ULL;
+        return x ^ (x >> 33);
+    };
+    auto add = [&](uint64_t v) {
+        h1 = mix(h1 ^ v) + h2;
+        h2 = mix(h2 + v * 0x9e3779b97f4a7c15ULL) ^ h1;
+    };
+    auto addString = [&](const string& s) {
+        add(s.size());
+        for (unsigned char ch : s) add(ch);
+    };
+
+    set<int> used;
+    for (auto const& row : canon.transitions)
+        for (auto const& t : row.second) used.insert(t.first);
+    vector<int> symbols;
+    for (auto const& p : canon.input_id_to_char)
+        if (used.count(p.first)) symbols.push_back(p.first);
+
+    add(canon.states.size());
+    add(symbols.size());
+    for (int c : symbols) addString(canon.input_id_to_char.at(c));
+    for (int u : canon.states) {
+        add(canon.final_states.count(u) ? 1 : 0);
+        auto ac = canon.accept_class.find(u);
+        if (ac != canon.accept_class.end()) { add(1); addString(ac->second); }
+        else add(0);
+        auto it = canon.transitions.find(u);
+        auto out = canon.transition_output.find(u);
+        for (int c : symbols) {
+            int target = -1;
+            if (it != canon.transitions.end()) {
+                auto t = it->second.find(c);
+                if (t != it->second.end()) target = t->second;
+            }
+            add((uint64_t)(int64_t)target);
+            const string* o = nullptr;
+            if (out != canon.transition_output.end()) {
+                auto e = out->second.find(c);
+                if (e != out->second.end()) o = &e->second;
+            }
+            if (o) { add(1); addString(*o); }
+            else add(0);
+        }
+    }
+
+    stringstream ss;
+    ss << hex << setfill('0') << setw(16) << h1 << setw(16) << h2;
+    return ss.str();
+}
+
+// === METRICS ===
+// Hàm lấy memory usage (Windows)
+inline size_t getCurrentMemoryUsage() {
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
+        return pmc.WorkingSetSize / 1024; // Convert to KB
+    }
+    return 0;
+}
+
+inline size_t getPeakMemoryUsage() {
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
+        return pmc.PeakWorkingSetSize / 1024; // Convert to KB
+    }
+    return 0;
+}
+
+// Hàm lấy CPU usage (Windows)
+inline double getCPUUsage() {
+    static ULARGE_INTEGER lastCPU, lastSysCPU, lastUserCPU;
+    static int numProcessors;
+    static HANDLE self;
+    static bool initialized = false;
+
+    if (!initialized) {
+        SYSTEM_INFO sysInfo;
+        FILETIME ftime, fsys, fuser;
+        GetSystemInfo(&sysInfo);
+        numProcessors = sysInfo.dwNumberOfProcessors;
+        GetSystemTimeAsFileTime(&ftime);
+        memcpy(&lastCPU, &ftime, sizeof(FILETIME));
+        self = GetCurrentProcess();
+        GetProcessTimes(self, &ftime, &ftime, &fsys, &fuser);
+        memcpy(&lastSysCPU, &fsys, sizeof(FILETIME));
+        memcpy(&lastUserCPU, &fuser, sizeof(FILETIME));
+        initialized = true;
+        return 0.0;
+    }
+
+    FILETIME ftime, fsys, fuser;
+    ULARGE_INTEGER now, sys, user;
+    double percent;
+
+    GetSystemTimeAsFileTime(&ftime);
+    memcpy(&now, &ftime, sizeof(FILETIME));
+    GetProcessTimes(self, &ftime, &ftime, &fsys, &fuser);
+    memcpy(&sys, &fsys, sizeof(FILETIME));
+    memcpy(&user, &fuser, sizeof(FILETIME));
+    
+    percent = (sys.QuadPart - lastSysCPU.QuadPart) + (user.QuadPart - lastUserCPU.QuadPart);
+    percent /= (now.QuadPart - lastCPU.QuadPart);
+    percent /= numProcessors;
+    
+    lastCPU = now;
+    lastUserCPU = user;
+    lastSysCPU = sys;
+
+    return percent * 100.0;
+}
+
+// Hàm trích xuất test case label từ filename
+inline string extractTestCaseLabel(const string& filename) {
+    // Extract from filename like "1000_states_dfa.json" -> "1000"
+    size_t pos = filename.find_last_of("/\\");
+    string basename = (pos == string::npos) ? filename : filename.substr(pos + 1);
+    
+    // Try to extract number at the beginning
+    size_t underscore = basename.find('_');
+    if (underscore != string::npos) {
+        return basename.substr(0, underscore);
+    }
+    
+    // If no underscore, return basename without extension
+    size_t dot = basename.find_last_of('.');
+    return (dot == string::npos) ? basename : basename.substr(0, dot);
+}
+
+// Kiểm tra kết quả với ground truth do DFA_generator sinh ra (*.truth.json) trong O(n):
+// mỗi nhóm phải cùng một lớp tối thiểu, hai nhóm khác nhau phải khác lớp.
+inline string checkGroundTruth(const DFA& minDFA, const string& truthFile) {
+    ifstream f(truthFile);
+    if (!f.is_open()) throw runtime_error("Khong mo duoc file ground truth: " + truthFile);
+    json truth; f >> truth;
+    string prefix = truth.value("state_prefix", "A");
+    const vector<int> min_class = truth["min_class"].get<vector<int>>();
+    int expected = truth["expected_min_states"];
+
+    vector<int> owner(expected, -1); // lớp tối thiểu -> nhóm đầu ra đã nhận lớp đó
+    for (int g : minDFA.states) {
+        const string& name = minDFA.state_id_to_name.at(g);
+        int group_class = -1;
+        size_t pos = 1; // Bỏ qua '{'
+        while (pos < name.size()) {
+            size_t end = name.find_first_of(",}", pos);
+            if (end == string::npos) end = name.size();
+            string member = name.substr(pos, end - pos);
+            pos = end + 1;
+            if (member.compare(0, prefix.size(), prefix) != 0)
+                return "FAIL (trang thai la: " + member + ")";
+            size_t idx = stoul(member.substr(prefix.size()));
+            if (idx >= min_class.size() || min_class[idx] < 0)
+                return "FAIL (trang thai khong hop le: " + member + ")";
+            if (group_class == -1) group_class = min_class[idx];
+            else if (group_class != min_class[idx])
+                return "FAIL (gop sai: " + name + ")";
+        }
+        if (group_class < 0 || group_class >= expected) return "FAIL (nhom rong: " + name + ")";
+        if (owner[group_class] != -1) return "FAIL (tach sai lop " + to_string(group_class) + ")";
+        owner[group_class] = g;
+    }
+    if ((int)minDFA.states.size() != expected)
+        return "FAIL (" + to_string(minDFA.states.size()) + " != " + to_string(expected) + ")";
+    return "PASS";
+}
+
+#endif // DFA_CORE_HPP
@@ -4,96 +4,1144 @@
 #include <string>
 #include <set>
 #include <map>
+#include <tuple>
 #include <algorithm>
 #include <queue>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <thread>
 #include <iomanip>
 #include <chrono>
 #include <sstream>
 #include <windows.h>
 #include <psapi.h>
-#include "json.hpp" // File json.hpp phải nằm cùng thư mục
-
-using json = nlohmann::json;
-using namespace std;
-
-// === PHẦN 1: CẤU TRÚC DFA ===
-struct DFA {
-    set<int> states;
-    set<int> alphabet;
-    map<int, map<int, int>> transitions;
-    int start_state = -1;
-    set<int> final_states;
-    
-    // Mapping tên <-> ID
-    map<int, string> state_id_to_name;
-    map<string, int> state_name_to_id;
-    map<int, string> input_id_to_char;
-    map<string, int> input_char_to_id;
-    int state_counter = 0;
-    int input_counter = 0;
-
-    int getStateID(string name) {
-        if (state_name_to_id.find(name) == state_name_to_id.end()) {
-            state_name_to_id[name] = state_counter;
-            state_id_to_name[state_counter] = name;
-            states.insert(state_counter);
-            state_counter++;
-        }
-        return state_name_to_id[name];
-    }
-    int getInputID(string char_str) {
-        if (input_char_to_id.find(char_str) == input_char_to_id.end()) {
-            input_char_to_id[char_str] = input_counter;
-            input_id_to_char[input_counter] = char_str;
-            alphabet.insert(input_counter);
-            input_counter++;
-        }
-        return input_char_to_id[char_str];
-    }
-    void addTransition(string from, string input_char, string to) {
-        int u = getStateID(from);
-        int v = getStateID(to);
-        int c = getInputID(input_char);
-        transitions[u][c] = v;
-    }
-    void setStart(string name) { start_state = getStateID(name); }
-    void addFinal(string name) { final_states.insert(getStateID(name)); }
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <cctype>
+#include "hopcroft.hpp" // Cấu trúc DFA dùng chung và lớp HopcroftSolver
+#include "mapped_file.hpp"
+
+// === PHẦN 2b: TỐI THIỂU HÓA TĂNG DẦN ===
+// Delta giữa hai phiên bản DFA:
+// {"add": [{"from", "input", "target_state", "output"?}], "remove": [{"from", "input"}],
+//  "flip_end": [tên]}
+struct DFAEdit {
+    string from, input, target; // target rỗng = xóa cạnh
+    string output;              // Output Mealy của cạnh thêm (rỗng = không có)
+};
+
+struct DFADelta {
+    vector<DFAEdit> edits;
+    vector<string> flip_end;
+    size_t size() const { return edits.size() + flip_end.size(); }
 };
 
-// Hàm đọc/ghi JSON
-DFA loadDFA_JSON(string filename) {
+DFADelta loadDelta_JSON(string filename) {
     ifstream f(filename);
-    if (!f.is_open()) throw runtime_error("Khong mo duoc file input: " + filename);
+    if (!f.is_open()) throw runtime_error("Khong mo duoc file delta: " + filename);
     json j; f >> j;
+    DFADelta delta;
+    for (auto& t : j.value("add", json::array()))
+        delta.edits.push_back({t["from"], t["input"], t["target_state"], t.value("output", "")});
+    for (auto& t : j.value("remove", json::array()))
+        delta.edits.push_back({t["from"], t["input"], "", ""});
+    for (auto& name : j.value("flip_end", json::array())) delta.flip_end.push_back(name);
+    return delta;
+}
+
+// Giữ DFA gốc (bảng phẳng + cạnh ngược), phân hoạch tối thiểu và DFA kết quả trong bộ nhớ.
+// apply() sửa phân hoạch cục bộ thay vì tối thiểu hóa lại:
+//  1. Tách: mỗi trạng thái bị sửa thành khối đơn, rồi Hopcroft chỉ từ các khối đơn đó.
+//     Phân hoạch cũ ổn định với mọi cạnh không bị sửa, nên chỉ tiền nhiệm (bắc cầu)
+//     của các trạng thái bị sửa có thể bị tách.
+//  2. Gộp: khối không tới được trạng thái bị sửa giữ nguyên hành vi nên đôi một không
+//     tương đương; chỉ cần tối thiểu hóa DFA thương thu hẹp trên các khối tới được trạng
+//     thái bị sửa (vùng A) cộng các khối ngoài A có thể tương đương một khối trong A.
+//  3. Kết quả: chỉ dựng lại tên và hàng của các khối có thành viên, hàng hoặc tính
+//     tới được thay đổi.
+// Delta lớn hơn fallback_ratio * n hoặc có ký tự mới: tối thiểu hóa lại toàn bộ.
+class IncrementalMinimizer {
+public:
+    SolverControl control;
+    double fallback_ratio = 0.05;
+    bool last_fallback = false;
+    int last_region = 0; // Số khối của DFA thương được tối thiểu hóa ở lần gộp gần nhất
+
+    // control áp dụng cho cả lần tối thiểu hóa ban đầu / dự phòng lẫn các lần apply
+    explicit IncrementalMinimizer(const DFA& input, const SolverControl& ctl = SolverControl())
+        : control(ctl), dfa(input) { rebuild(); }
+
+    // Khởi tạo từ kết quả cũ của solver (tên trạng thái dạng "{A,B}"): phân hoạch được
+    // đọc lại từ tên và kiểm tra tính ổn định; không khớp thì tối thiểu hóa từ đầu.
+    IncrementalMinimizer(const DFA& input, const DFA& previous, const SolverControl& ctl = SolverControl())
+        : control(ctl), dfa(input) {
+        loadTables();
+        if (!loadPartition(previous)) { rebuild(); return; }
+        vector<int> all(part.blockCount());
+        for (int b = 0; b < part.blockCount(); ++b) all[b] = b;
+        mergeRegion(all);
+        resetResult();
+    }
+
+    const DFA& current() const { return dfa; }
+
+    void apply(const DFADelta& delta) {
+        last_fallback = false;
+        last_region = 0;
+        // Kiểm tra trước khi sửa để delta sai không bị áp dụng dở dang
+        for (const DFAEdit& e : delta.edits) {
+            if (!e.target.empty()) continue;
+            if (!dfa.state_name_to_id.count(e.from))
+                throw runtime_error("Delta xoa canh cua trang thai khong ton tai: " + e.from);
+            if (!dfa.input_char_to_id.count(e.input))
+                throw runtime_error("Delta xoa canh voi input khong ton tai: " + e.input);
+        }
+        for (const string& name : delta.flip_end)
+            if (!dfa.state_name_to_id.count(name))
+                throw runtime_error("Delta flip_end trang thai khong ton tai: " + name);
+        bool new_symbol = false;
+        for (const DFAEdit& e : delta.edits)
+            if (!dfa.input_char_to_id.count(e.input)) new_symbol = true;
+
+        // Áp dụng lên DFA dạng map (dùng khi xuất kết quả), ghi lại các trạng thái bị sửa
+        vector<int> touched;
+        for (const DFAEdit& e : delta.edits) {
+            if (e.target.empty()) {
+                int u = dfa.state_name_to_id.at(e.from);
+                dfa.transitions[u].erase(dfa.input_char_to_id.at(e.input));
+                dfa.transition_output[u].erase(dfa.input_char_to_id.at(e.input));
+                touched.push_back(u);
+            } else {
+                dfa.addTransition(e.from, e.input, e.target);
+                int u = dfa.state_name_to_id.at(e.from);
+                if (e.output.empty()) dfa.transition_output[u].erase(dfa.input_char_to_id.at(e.input));
+                else dfa.setOutput(e.from, e.input, e.output);
+                touched.push_back(u);
+            }
+        }
+        for (const string& name : delta.flip_end) {
+            int u = dfa.state_name_to_id.at(name);
+            if (dfa.final_states.count(u)) dfa.final_states.erase(u);
+            else dfa.final_states.insert(u);
+            touched.push_back(u);
+        }
+
+        if (new_symbol || delta.size() > fallback_ratio * max(n, 1)) {
+            last_fallback = true;
+            rebuild();
+            return;
+        }
+
+        // Trạng thái mới (tên chưa có trong DFA gốc) thành khối đơn
+        int old_n = n;
+        n = dfa.state_counter;
+        trans.resize((size_t)n * k, -1);
+        out_label.resize(n, 0);
+        reach.resize(n, 0);
+        part.log_splits = true;
+        for (int u = old_n; u < n; ++u) {
+            part.push(part.addElement(u));
+            touched.push_back(u);
+        }
+
+        bool shrink = false; // Có cạnh cũ bị xóa / đổi đích: tập tới được có thể co lại
+        for (int u : touched) {
+            out_label[u] = labelOf(u);
+            auto row = dfa.transitions.find(u);
+            for (int c = 0; c < k; ++c) {
+                int v = -1;
+                if (row != dfa.transitions.end() && row->second.count(c)) v = row->second.at(c);
+                int old = trans[(size_t)u * k + c];
+                if (old != -1 && old != v) shrink = true;
+                setTransition(u, c, v);
+            }
+            part.push(part.isolate(u));
+        }
+        if (extra_edges > preds.size() / 4 + 1024) buildInverse();
+
+        SolverProgress progress;
+        part.refine(k, [&](int v, int c, auto f) { forEachPred(v, c, f); }, control, progress);
+        part.log_splits = false;
+
+        // Khối bị tách đổi tên; trạng thái sang khối mới làm đổi hàng của tiền nhiệm
+        vector<int> moved;
+        for (auto const& s : part.split_log) {
+            if (s.first >= 0) markDirty(s.first);
+            markDirty(s.second);
+            for (int i = part.first[s.second]; i < part.last[s.second]; ++i) moved.push_back(part.elements[i]);
+        }
+        part.split_log.clear();
+
+        vector<int> reach_changed;
+        updateReach(shrink, touched, reach_changed);
+        mergeAround(touched, moved);
+
+        for (int u : moved)
+            for (int c = 0; c < k; ++c) forEachPred(u, c, [&](int p) { markDirty(part.block[p]); });
+        for (int u : reach_changed) markDirty(part.block[u]);
+        for (int u : touched) markDirty(part.block[u]);
+        refreshResult();
+    }
+
+    // DFA tối thiểu của phiên bản hiện tại (chỉ các trạng thái tới được, như HopcroftSolver::minimize);
+    // id trạng thái là id khối nên không liên tục
+    const DFA& result() const { return res; }
+
+private:
     DFA dfa;
+    int n = 0, k = 0;
+    vector<int> trans;      // trans[u * k + c] = v hoặc -1
+    // Nhãn đầu ra (OutputKey) của từng trạng thái; id cấp dần, không liên tục
+    map<OutputKey, int> label_ids;
+    vector<int> out_label;
+    // Cạnh ngược: CSR dựng một lần (preds của (v, c) tăng dần theo u) + danh sách phụ
+    // cho cạnh thêm sau đó. Cạnh đã xóa được lọc bằng trans khi duyệt.
+    int inverse_n = 0;
+    vector<size_t> offset;
+    vector<int> preds;
+    unordered_map<size_t, vector<int>> extra;
+    size_t extra_edges = 0;
+    RefinablePartition part;
+    // Kết quả: trạng thái b của res là khối b (chỉ các thành viên tới được)
+    DFA res;
+    vector<char> reach;
+    vector<int> dirty;
+    vector<char> dirty_mark;
+    // Vùng nhớ tạm cho mergeAround / mergeRegion, luôn được trả về 0 / -1 sau khi dùng
+    vector<char> state_mark, block_mark;
+    vector<int> local_id, pred_stamp;
+    int stamp = 0;
+
+    enum { OUTSIDE = 0, IN_A = 1, A_EXIT = 2, PARTNER = 3 };
+
+    void loadTables() {
+        n = dfa.state_counter; k = dfa.input_counter;
+        trans.assign((size_t)n * k, -1);
+        out_label.assign(n, 0);
+        for (auto const& row : dfa.transitions)
+            for (auto const& p : row.second) trans[(size_t)row.first * k + p.first] = p.second;
+        for (int u = 0; u < n; ++u) out_label[u] = labelOf(u);
+        buildInverse();
+    }
+
+    int labelOf(int u) {
+        return label_ids.emplace(outputKey(dfa, u), (int)label_ids.size()).first->second;
+    }
+
+    // Đánh số lại nhãn raw[i] thành 0..num-1 (chỉ các nhãn có mặt) cho RefinablePartition::init
+    static int compactLabels(const vector<int>& raw, vector<int>& label) {
+        unordered_map<int, int> dense;
+        label.resize(raw.size());
+        for (size_t i = 0; i < raw.size(); ++i)
+            label[i] = dense.emplace(raw[i], (int)dense.size()).first->second;
+        return (int)dense.size();
+    }
+
+    void buildInverse() {
+        inverse_n = n;
+        offset.assign((size_t)n * k + 1, 0);
+        for (size_t i = 0; i < trans.size(); ++i)
+            if (trans[i] != -1) offset[(size_t)trans[i] * k + i % k + 1]++;
+        for (size_t i = 1; i < offset.size(); ++i) offset[i] += offset[i - 1];
+        preds.assign(offset.back(), 0);
+        vector<size_t> fill(offset.begin(), offset.end() - 1);
+        for (size_t i = 0; i < trans.size(); ++i)
+            if (trans[i] != -1) preds[fill[(size_t)trans[i] * k + i % k]++] = (int)(i / k);
+        extra.clear();
+        extra_edges = 0;
+    }
+
+    bool inBase(int u, int c, int v) const {
+        if (v >= inverse_n) return false;
+        size_t key = (size_t)v * k + c;
+        return binary_search(preds.begin() + offset[key], preds.begin() + offset[key + 1], u);
+    }
+
+    void setTransition(int u, int c, int v) {
+        trans[(size_t)u * k + c] = v;
+        if (v == -1 || inBase(u, c, v)) return;
+        vector<int>& list = extra[(size_t)v * k + c];
+        if (find(list.begin(), list.end(), u) == list.end()) { list.push_back(u); extra_edges++; }
+    }
+
+    template <class F>
+    void forEachPred(int v, int c, F&& f) const {
+        size_t key = (size_t)v * k + c;
+        if (v < inverse_n)
+            for (size_t i = offset[key]; i < offset[key + 1]; ++i)
+                if (trans[(size_t)preds[i] * k + c] == v) f(preds[i]);
+        auto it = extra.find(key);
+        if (it != extra.end())
+            for (int u : it->second)
+                if (trans[(size_t)u * k + c] == v) f(u);
+    }
+
+    void rebuild() {
+        loadTables();
+        vector<int> label;
+        int num_labels = compactLabels(out_label, label);
+        part.init(label, num_labels);
+        for (int b = 0; b < part.blockCount(); ++b) part.push(b);
+        SolverProgress progress;
+        part.refine(k, [&](int v, int c, auto f) { forEachPred(v, c, f); }, control, progress);
+        resetResult();
+    }
+
+    // Đọc phân hoạch từ tên "{A,B,...}" của kết quả cũ. Trạng thái không có trong kết quả
+    // (không tới được) thành khối đơn. Trả về false nếu tên không khớp hoặc phân hoạch
+    // không ổn định với DFA hiện tại.
+    bool loadPartition(const DFA& previous) {
+        vector<int> label(n, -1);
+        int num_labels = 0;
+        for (int m : previous.states) {
+            const string& name = previous.state_id_to_name.at(m);
+            if (name.size() < 2 || name.front() != '{' || name.back() != '}') return false;
+            stringstream ss(name.substr(1, name.size() - 2));
+            string member;
+            while (getline(ss, member, ',')) {
+                auto it = dfa.state_name_to_id.find(member);
+                if (it == dfa.state_name_to_id.end() || label[it->second] != -1) return false;
+                label[it->second] = num_labels;
+            }
+            num_labels++;
+        }
+        for (int u = 0; u < n; ++u) if (label[u] == -1) label[u] = num_labels++;
+        part.init(label, num_labels);
+
+        // Ổn định: mọi trạng thái trong khối cùng nhãn đầu ra và cùng khối đích
+        for (int b = 0; b < part.blockCount(); ++b) {
+            int rep = part.elements[part.first[b]];
+            for (int i = part.first[b] + 1; i < part.last[b]; ++i) {
+                int u = part.elements[i];
+                if (out_label[u] != out_label[rep]) return false;
+                for (int c = 0; c < k; ++c) {
+                    int v = trans[(size_t)u * k + c], w = trans[(size_t)rep * k + c];
+                    if ((v == -1) != (w == -1) || (v != -1 && part.block[v] != part.block[w])) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    int rep(int b) const { return part.elements[part.first[b]]; }
+
+    // Các khối có cạnh c vào khối b (mỗi khối một lần)
+    void predBlocks(int b, int c, vector<int>& out) {
+        out.clear();
+        pred_stamp.resize(part.blockCount(), 0);
+        ++stamp;
+        for (int i = part.first[b]; i < part.last[b]; ++i)
+            forEachPred(part.elements[i], c, [&](int u) {
+                int p = part.block[u];
+                if (pred_stamp[p] != stamp) { pred_stamp[p] = stamp; out.push_back(p); }
+            });
+    }
+
+    bool inA(int b) const { return block_mark[b] == IN_A || block_mark[b] == A_EXIT; }
+
+    // z (ngoài A) có thể tương đương a (trong A): cùng nhãn, cùng tập cạnh, và đích ngoài A
+    // của a phải trùng khối đích của z (khối ngoài A đôi một không tương đương)
+    bool compatible(int a, int z) const {
+        int ra = rep(a), rz = rep(z);
+        if (out_label[ra] != out_label[rz]) return false;
+        for (int c = 0; c < k; ++c) {
+            int ta = trans[(size_t)ra * k + c], tz = trans[(size_t)rz * k + c];
+            if ((ta == -1) != (tz == -1)) return false;
+            if (ta != -1 && !inA(part.block[ta]) && part.block[ta] != part.block[tz]) return false;
+        }
+        return true;
+    }
+
+    // Gộp quanh các trạng thái bị sửa; moved nhận các trạng thái đổi id khối
+    void mergeAround(const vector<int>& touched, vector<int>& moved) {
+        // 1. Vùng A: khối chứa trạng thái tới được (theo chiều thuận) một trạng thái bị sửa
+        state_mark.resize(n, 0);
+        vector<int> S;
+        for (int u : touched) if (!state_mark[u]) { state_mark[u] = 1; S.push_back(u); }
+        for (size_t i = 0; i < S.size(); ++i)
+            for (int c = 0; c < k; ++c)
+                forEachPred(S[i], c, [&](int u) { if (!state_mark[u]) { state_mark[u] = 1; S.push_back(u); } });
+        for (int u : S) state_mark[u] = 0;
+
+        block_mark.resize(part.blockCount(), OUTSIDE);
+        vector<int> region;
+        for (int u : S)
+            if (block_mark[part.block[u]] == OUTSIDE) { block_mark[part.block[u]] = IN_A; region.push_back(part.block[u]); }
+        size_t num_a = region.size();
+        if ((int)num_a < part.blockCount() - (int)part.free_blocks.size()) addPartners(region, num_a);
+        for (int b : region) block_mark[b] = OUTSIDE;
+        mergeRegion(region, &moved);
+    }
+
+    // 2. Khối ngoài A tương đương khối a ∈ A: nếu a có đường ra khỏi A qua a' --c--> y
+    // thì đối tác z có z' --c--> y đúng khối y với z' tương đương a', nên lan ngược theo cặp
+    // (a', z') từ các cạnh ra khỏi A là đủ. Khối A không ra được ngoài A (thành phần đóng)
+    // có thể tương đương khối bất kỳ: khi đó lấy mọi khối làm vùng gộp.
+    void addPartners(vector<int>& region, size_t num_a) {
+        vector<int> queue, list, list2;
+        for (size_t i = 0; i < num_a; ++i) {
+            int a = region[i], ra = rep(a);
+            for (int c = 0; c < k; ++c) {
+                int v = trans[(size_t)ra * k + c];
+                if (v != -1 && !inA(part.block[v])) { block_mark[a] = A_EXIT; queue.push_back(a); break; }
+            }
+        }
+        for (size_t i = 0; i < queue.size(); ++i)
+            for (int c = 0; c < k; ++c) {
+                predBlocks(queue[i], c, list);
+                for (int p : list) if (block_mark[p] == IN_A) { block_mark[p] = A_EXIT; queue.push_back(p); }
+            }
+        if (queue.size() < num_a) {
+            for (int b = 0; b < part.blockCount(); ++b)
+                if (part.blockSize(b) > 0 && block_mark[b] == OUTSIDE) { block_mark[b] = PARTNER; region.push_back(b); }
+            return;
+        }
+
+        unordered_set<uint64_t> seen;
+        vector<pair<int, int>> pairs;
+        auto tryPair = [&](int a, int z) {
+            if (inA(z) || !compatible(a, z)) return;
+            if (!seen.insert((uint64_t)a << 32 | (uint32_t)z).second) return;
+            pairs.push_back({a, z});
+            if (block_mark[z] == OUTSIDE) { block_mark[z] = PARTNER; region.push_back(z); }
+        };
+        // Hạt giống: đối tác của a phải có cạnh ra đầu tiên của a (ra khỏi A) vào cùng khối
+        for (size_t i = 0; i < num_a; ++i) {
+            int a = region[i], ra = rep(a);
+            for (int c = 0; c < k; ++c) {
+                int v = trans[(size_t)ra * k + c];
+                if (v == -1 || inA(part.block[v])) continue;
+                predBlocks(part.block[v], c, list);
+                for (int z : list) tryPair(a, z);
+                break;
+            }
+        }
+        for (size_t i = 0; i < pairs.size(); ++i) {
+            int a = pairs[i].first, z = pairs[i].second;
+            for (int c = 0; c < k; ++c) {
+                predBlocks(a, c, list);
+                list.erase(remove_if(list.begin(), list.end(), [&](int p) { return !inA(p); }), list.end());
+                if (list.empty()) continue;
+                predBlocks(z, c, list2);
+                for (int p : list) for (int q : list2) tryPair(p, q);
+            }
+        }
+    }
+
+    // Tối thiểu hóa DFA thương thu hẹp trên các khối region rồi gộp các khối tương đương.
+    // Đích ngoài region là nguyên tử, mỗi khối một nhãn riêng: chúng đôi một không tương
+    // đương và không tương đương khối nào trong region.
+    void mergeRegion(const vector<int>& region, vector<int>* moved = nullptr) {
+        int R = (int)region.size();
+        local_id.resize(part.blockCount(), -1);
+        for (int i = 0; i < R; ++i) local_id[region[i]] = i;
+        vector<int> outside, qtrans((size_t)R * k, -1), raw(R), label;
+        for (int i = 0; i < R; ++i) {
+            int r = rep(region[i]);
+            raw[i] = out_label[r];
+            for (int c = 0; c < k; ++c) {
+                int v = trans[(size_t)r * k + c];
+                if (v == -1) continue;
+                int b = part.block[v];
+                if (local_id[b] == -1) { local_id[b] = R + (int)outside.size(); outside.push_back(b); }
+                qtrans[(size_t)i * k + c] = local_id[b];
+            }
+        }
+        for (int b : region) local_id[b] = -1;
+        for (int b : outside) local_id[b] = -1;
+        int num_labels = compactLabels(raw, label);
+        int Q = R + (int)outside.size();
+        qtrans.resize((size_t)Q * k, -1);
+        for (size_t j = 0; j < outside.size(); ++j) label.push_back(num_labels + (int)j);
+        last_region = R;
+
+        vector<size_t> qoffset((size_t)Q * k + 1, 0);
+        for (size_t i = 0; i < qtrans.size(); ++i)
+            if (qtrans[i] != -1) qoffset[(size_t)qtrans[i] * k + i % k + 1]++;
+        for (size_t i = 1; i < qoffset.size(); ++i) qoffset[i] += qoffset[i - 1];
+        vector<int> qpreds(qoffset.back());
+        vector<size_t> fill(qoffset.begin(), qoffset.end() - 1);
+        for (size_t i = 0; i < qtrans.size(); ++i)
+            if (qtrans[i] != -1) qpreds[fill[(size_t)qtrans[i] * k + i % k]++] = (int)(i / k);
+
+        RefinablePartition q;
+        q.init(label, num_labels + (int)outside.size());
+        for (int b = 0; b < q.blockCount(); ++b) q.push(b);
+        SolverProgress progress;
+        q.refine(k, [&](int v, int c, auto f) {
+            size_t key = (size_t)v * k + c;
+            for (size_t i = qoffset[key]; i < qoffset[key + 1]; ++i) f(qpreds[i]);
+        }, control, progress);
+        if (q.blockCount() == Q) return;
+
+        // Giữ id của khối lớn nhất trong mỗi lớp để ít trạng thái đổi khối nhất
+        vector<vector<int>> groups(q.blockCount());
+        for (int i = 0; i < R; ++i) groups[q.block[i]].push_back(region[i]);
+        for (vector<int>& g : groups) {
+            if (g.size() < 2) continue;
+            auto big = max_element(g.begin(), g.end(), [&](int x, int y) { return part.blockSize(x) < part.blockSize(y); });
+            swap(*big, g.front());
+            vector<int> others(g.begin() + 1, g.end());
+            markDirty(g.front());
+            for (int b : others) {
+                markDirty(b);
+                if (moved)
+                    for (int i = part.first[b]; i < part.last[b]; ++i) moved->push_back(part.elements[i]);
+            }
+            part.mergeInto(g.front(), others);
+        }
+    }
+
+    void computeReach() {
+        reach.assign(n, 0);
+        if (dfa.start_state == -1) return;
+        vector<int> order{dfa.start_state};
+        reach[dfa.start_state] = 1;
+        for (size_t i = 0; i < order.size(); ++i)
+            for (int c = 0; c < k; ++c) {
+                int v = trans[(size_t)order[i] * k + c];
+                if (v != -1 && !reach[v]) { reach[v] = 1; order.push_back(v); }
+            }
+    }
+
+    // Chỉ thêm cạnh: loang tiếp từ các trạng thái bị sửa. Có cạnh bị xóa / đổi đích:
+    // duyệt lại trên bảng phẳng (không dựng lại tên) và so với lần trước.
+    void updateReach(bool shrink, const vector<int>& touched, vector<int>& changed) {
+        if (shrink) {
+            vector<char> old;
+            old.swap(reach);
+            computeReach();
+            for (int u = 0; u < n; ++u) if (old[u] != reach[u]) changed.push_back(u);
+            return;
+        }
+        vector<int> order;
+        for (int u : touched) if (reach[u]) order.push_back(u);
+        for (size_t i = 0; i < order.size(); ++i)
+            for (int c = 0; c < k; ++c) {
+                int v = trans[(size_t)order[i] * k + c];
+                if (v != -1 && !reach[v]) { reach[v] = 1; order.push_back(v); changed.push_back(v); }
+            }
+    }
+
+    void markDirty(int b) {
+        if ((int)dirty_mark.size() <= b) dirty_mark.resize(part.blockCount(), 0);
+        if (!dirty_mark[b]) { dirty_mark[b] = 1; dirty.push_back(b); }
+    }
+
+    void resetResult() {
+        res = DFA();
+        res.input_char_to_id = dfa.input_char_to_id;
+        res.input_id_to_char = dfa.input_id_to_char;
+        res.alphabet = dfa.alphabet;
+        res.input_counter = dfa.input_counter;
+        computeReach();
+        for (int b = 0; b < part.blockCount(); ++b) markDirty(b);
+        refreshResult();
+    }
+
+    // Dựng lại các trạng thái bẩn của res. Hai lượt: xóa hết tên cũ trước để tên mới
+    // không bị xóa nhầm khi trùng tên cũ của một khối bẩn khác.
+    void refreshResult() {
+        for (int b : dirty) {
+            auto it = res.state_id_to_name.find(b);
+            if (it == res.state_id_to_name.end()) continue;
+            res.state_name_to_id.erase(it->second);
+            res.state_id_to_name.erase(it);
+            res.states.erase(b);
+            res.final_states.erase(b);
+            res.accept_class.erase(b);
+            res.transitions.erase(b);
+            res.transition_output.erase(b);
+        }
+        vector<string> names;
+        for (int b : dirty) {
+            dirty_mark[b] = 0;
+            names.clear();
+            int r = -1;
+            for (int i = part.first[b]; i < part.last[b]; ++i) {
+                int u = part.elements[i];
+                if (!reach[u]) continue;
+                names.push_back(dfa.state_id_to_name.at(u));
+                if (r == -1 || u < r) r = u;
+            }
+            if (r == -1) continue; // Khối rỗng (đã gộp) hoặc không tới được
+            sort(names.begin(), names.end());
+            string name = "{";
+            for (size_t i = 0; i < names.size(); ++i) name += (i == 0 ? "" : ",") + names[i];
+            name += "}";
+            res.states.insert(b);
+            res.state_id_to_name[b] = name;
+            res.state_name_to_id[name] = b;
+            res.state_counter = max(res.state_counter, b + 1);
+            if (dfa.final_states.count(r)) res.final_states.insert(b);
+            auto ac = dfa.accept_class.find(r);
+            if (ac != dfa.accept_class.end()) res.accept_class[b] = ac->second;
+            for (int c = 0; c < k; ++c) {
+                int v = trans[(size_t)r * k + c];
+                if (v != -1) res.transitions[b][c] = part.block[v];
+            }
+            auto out = dfa.transition_output.find(r);
+            if (out != dfa.transition_output.end() && !out->second.empty())
+                res.transition_output[b] = out->second;
+        }
+        dirty.clear();
+        res.start_state = dfa.start_state == -1 ? -1 : part.block[dfa.start_state];
+    }
+};
+
+// === PHẦN 2c: HOPCROFT NGOÀI BỘ NHỚ (OUT-OF-CORE) ===
+// Hopcroft trên DFA nhị phân lớn hơn RAM. Bảng chuyển là file input ánh xạ chỉ đọc;
+// chỉ mục ngược (CSR theo khóa v * k + c) và các mảng phân hoạch 32-bit nằm trong file
+// tạm ánh xạ. Thứ tự truy cập được chọn để lỗi trang đi tuần tự:
+//  - chỉ mục ngược dựng bằng hai lượt quét tuần tự bảng chuyển (đếm rồi điền), đếm
+//    thẳng vào offsets đã ánh xạ;
+//  - thành viên của splitter được chụp ra file tạm và sắp xếp theo từng đoạn, nên
+//    offsets/preds được đọc theo chiều tăng; tiền nhiệm X được sắp xếp trước khi đánh dấu.
+// Kết quả: khối được đánh số theo BFS từ trạng thái bắt đầu (bỏ khối không tới được).
+class ExternalHopcroft {
+public:
+    SolverControl control;
+    size_t memory_budget_bytes = (size_t)1024 << 20;
+    string temp_dir;
+
+    // Thống kê của lần chạy gần nhất
+    uint64_t num_states = 0, alphabet_size = 0, num_transitions = 0;
+    uint32_t result_states = 0;
+
+    void minimize(const string& inputFile, const string& outputFile) {
+        MappedFile input(inputFile);
+        if (input.bytes() < sizeof(BinaryDFAHeader)) throw runtime_error("File DFAB khong hop le: " + inputFile);
+        const BinaryDFAHeader& header = *input.as<BinaryDFAHeader>();
+        if (memcmp(header.magic, "DFAB", 4) != 0 || header.version != 1)
+            throw runtime_error("File DFAB khong hop le: " + inputFile);
+        uint64_t n = header.num_states, k = header.alphabet_size;
+        if (input.bytes() < sizeof(BinaryDFAHeader) + n * k * 4 + (n + 7) / 8)
+            throw runtime_error("File DFAB bi cat cut: " + inputFile);
+        num_states = n; alphabet_size = k;
+        trans = input.as<uint32_t>(sizeof(BinaryDFAHeader));
+        accepting = input.as<uint8_t>(sizeof(BinaryDFAHeader) + n * k * 4);
+        if (n == 0) { writeResult(outputFile, header.start_state); return; }
+
+        // Chỉ mục ngược
+        MappedFile inverse_offsets(tempFilePath(temp_dir, "hopcroft_offsets"), (n * k + 1) * 8, true);
+        offsets = inverse_offsets.as<uint64_t>();
+        num_transitions = countInverse(n, k);
+        MappedFile inverse_preds(tempFilePath(temp_dir, "hopcroft_preds"), max<uint64_t>(num_transitions, 1) * 4, true);
+        preds = inverse_preds.as<uint32_t>();
+        fillInverse(n, k);
+
+        // Phân hoạch: 3 mảng theo trạng thái + 3 mảng theo khối (tối đa n khối) + ảnh chụp splitter
+        // + ngăn xếp W và danh sách khối bị đánh dấu (mỗi khối xuất hiện tối đa một lần)
+        MappedFile partition(tempFilePath(temp_dir, "hopcroft_partition"), n * 4 * 9, true);
+        elements = partition.as<uint32_t>();
+        pos = elements + n; block = pos + n;
+        first = block + n; last = first + n; marked = last + n;
+        splitter = marked + n;
+        W = splitter + n; touched = W + n;
+        w_size = touched_size = 0;
+        MappedFile flags(tempFilePath(temp_dir, "hopcroft_in_w"), n, true);
+        in_w = flags.as<uint8_t>();
+        refine(n, k);
+
+        writeResult(outputFile, header.start_state);
+    }
+
+private:
+    const uint32_t* trans = nullptr;
+    const uint8_t* accepting = nullptr;
+    uint64_t* offsets = nullptr;
+    uint32_t* preds = nullptr;
+    uint32_t *elements = nullptr, *pos = nullptr, *block = nullptr;
+    uint32_t *first = nullptr, *last = nullptr, *marked = nullptr, *splitter = nullptr;
+    uint8_t* in_w = nullptr;
+    uint32_t block_count = 0;
+    uint32_t *W = nullptr, *touched = nullptr;
+    uint32_t w_size = 0, touched_size = 0;
+
+    bool isAccepting(uint64_t u) const { return (accepting[u / 8] >> (u % 8)) & 1; }
+
+    // Lượt 1: đếm cạnh vào của mỗi khóa (v, c) thẳng vào offsets[key + 1] (file tạm mới
+    // tạo toàn số 0), rồi cộng dồn. Trả về số cạnh.
+    uint64_t countInverse(uint64_t n, uint64_t k) {
+        SolverProgress progress;
+        control.poll(progress);
+        uint64_t m = 0;
+        for (uint64_t i = 0; i < n * k; ++i) {
+            uint32_t v = trans[i];
+            if (v == DFAB_NONE) continue;
+            offsets[(uint64_t)v * k + i % k + 1]++;
+            m++;
+        }
+        for (uint64_t key = 1; key <= n * k; ++key) offsets[key] += offsets[key - 1];
+        return m;
+    }
+
+    // Lượt 2: điền preds dùng offsets[key] làm con trỏ ghi, sau đó offsets[key] là cuối
+    // của khóa nên dịch lại một ô. u tăng dần nên preds của mỗi khóa đã sắp xếp.
+    void fillInverse(uint64_t n, uint64_t k) {
+        SolverProgress progress;
+        control.poll(progress);
+        for (uint64_t i = 0; i < n * k; ++i) {
+            uint32_t v = trans[i];
+            if (v != DFAB_NONE) preds[offsets[(uint64_t)v * k + i % k]++] = (uint32_t)(i / k);
+        }
+        for (uint64_t key = n * k; key > 0; --key) offsets[key] = offsets[key - 1];
+        offsets[0] = 0;
+    }
+
+    void push(uint32_t b) { if (!in_w[b]) { in_w[b] = 1; W[w_size++] = b; } }
+
+    uint32_t newBlock(uint32_t begin, uint32_t end) {
+        uint32_t nb = block_count++;
+        first[nb] = begin; last[nb] = end; marked[nb] = 0; in_w[nb] = 0;
+        for (uint32_t i = begin; i < end; ++i) block[elements[i]] = nb;
+        return nb;
+    }
+
+    // Đánh dấu X (đã sắp xếp): chuyển phần tử về đầu khối của nó
+    void mark(const vector<uint32_t>& X) {
+        for (uint32_t u : X) {
+            uint32_t b = block[u];
+            if (marked[b] == 0) touched[touched_size++] = b;
+            uint32_t target = first[b] + marked[b]++;
+            uint32_t w = elements[target];
+            elements[target] = u; elements[pos[u]] = w;
+            pos[w] = pos[u]; pos[u] = target;
+        }
+    }
+
+    // Tách các khối đã đánh dấu theo luật Hopcroft
+    void commit() {
+        for (uint32_t t = 0; t < touched_size; ++t) {
+            uint32_t b = touched[t];
+            uint32_t split = first[b] + marked[b];
+            marked[b] = 0;
+            if (split == last[b]) continue;
+            uint32_t nb = newBlock(first[b], split);
+            first[b] = split;
+            if (in_w[b]) push(nb);
+            else push((last[nb] - first[nb] <= last[b] - first[b]) ? nb : b);
+        }
+        touched_size = 0;
+    }
+
+    void refine(uint64_t n, uint64_t k) {
+        // {F, Q \ F}: hai lượt quét tuần tự bitmap chấp nhận
+        uint32_t cursor = 0;
+        for (int pass = 0; pass < 2; ++pass) {
+            uint32_t begin = cursor;
+            for (uint64_t u = 0; u < n; ++u) {
+                if (isAccepting(u) != (pass == 0)) continue;
+                elements[cursor] = (uint32_t)u; pos[u] = cursor; cursor++;
+            }
+            if (cursor > begin) push(newBlock(begin, cursor));
+        }
+
+        // X (tiền nhiệm đang đánh dấu) là thứ duy nhất trong RAM: tối đa ~1/8 ngân sách.
+        // Cạnh vào của cùng một ký tự không trùng nguồn, nên đánh dấu từng đoạn là đủ.
+        size_t chunk = max<size_t>(1024, memory_budget_bytes / 8 / sizeof(uint32_t));
+        vector<uint32_t> X;
+        X.reserve(chunk);
+        SolverProgress progress;
+        while (w_size > 0) {
+            progress.blocks = block_count;
+            progress.worklist = w_size;
+            control.poll(progress);
+            progress.rounds++;
+            uint32_t b = W[--w_size]; in_w[b] = 0;
+
+            // Chụp splitter (khối b có thể bị tách khi đánh dấu), sắp xếp từng đoạn
+            uint32_t size = last[b] - first[b];
+            memcpy(splitter, elements + first[b], (size_t)size * sizeof(uint32_t));
+            for (uint64_t s = 0; s < size; s += chunk)
+                sort(splitter + s, splitter + min<uint64_t>(size, s + chunk));
+
+            for (uint64_t c = 0; c < k; ++c) {
+                // Gom tiền nhiệm theo thứ tự splitter, cắt thành đoạn <= chunk phần tử
+                // (kể cả giữa danh sách tiền nhiệm của một trạng thái có bậc vào lớn)
+                X.clear();
+                for (uint64_t i = 0; i < size; ++i) {
+                    uint64_t key = (uint64_t)splitter[i] * k + c;
+                    for (uint64_t p = offsets[key]; p < offsets[key + 1];) {
+                        uint64_t take = min<uint64_t>(offsets[key + 1] - p, chunk - X.size());
+                        X.insert(X.end(), preds + p, preds + p + take);
+                        p += take;
+                        if (X.size() == chunk) { sort(X.begin(), X.end()); mark(X); X.clear(); }
+                    }
+                }
+                sort(X.begin(), X.end());
+                mark(X);
+                commit();
+            }
+        }
+    }
+
+    // Ghi DFA tối thiểu ở định dạng DFAB: BFS trên khối từ khối bắt đầu, new_id lưu trong
+    // marked (đã về 0 sau tinh chỉnh), hàng đợi dùng lại mảng pos.
+    void writeResult(const string& outputFile, uint32_t start) {
+        ofstream out(outputFile, ios::binary);
+        if (!out.is_open()) throw runtime_error("Khong mo duoc file output: " + outputFile);
+        uint64_t k = alphabet_size;
+        BinaryDFAHeader header = {{'D', 'F', 'A', 'B'}, 1, 0, (uint32_t)k, 0, {0, 0, 0}};
+        result_states = 0;
+        vector<uint8_t> accept_bits;
+        vector<uint32_t> row(k);
+        out.write((const char*)&header, sizeof(header));
+        if (num_states > 0 && start < num_states) {
+            for (uint32_t b = 0; b < block_count; ++b) marked[b] = DFAB_NONE;
+            uint32_t* queue = pos;
+            marked[block[start]] = 0;
+            queue[result_states++] = block[start];
+            for (uint32_t i = 0; i < result_states; ++i) {
+                uint32_t rep = elements[first[queue[i]]];
+                for (uint64_t c = 0; c < k; ++c) {
+                    uint32_t v = trans[rep * k + c];
+                    if (v == DFAB_NONE) { row[c] = DFAB_NONE; continue; }
+                    uint32_t tb = block[v];
+                    if (marked[tb] == DFAB_NONE) { marked[tb] = result_states; queue[result_states++] = tb; }
+                    row[c] = marked[tb];
+                }
+                out.write((const char*)row.data(), k * sizeof(uint32_t));
+                if (i % 8 == 0) accept_bits.push_back(0);
+                if (isAccepting(rep)) accept_bits.back() |= (uint8_t)(1u << (i % 8));
+            }
+        }
+        out.write((const char*)accept_bits.data(), accept_bits.size());
+        header.num_states = result_states;
+        out.seekp(0);
+        out.write((const char*)&header, sizeof(header));
+    }
+};
+
+// === PHẦN 2d: BẢNG CHỮ CÁI KÝ HIỆU (KHOẢNG MÃ UNICODE) ===
+// Cạnh được gán nhãn bằng khoảng code point [lo, hi] thay vì symbol nguyên tử, nên
+// lexer Unicode không phải khai triển 1.1M symbol. Cú pháp input trong JSON:
+//  - một ký tự (UTF-8) hoặc "U+XXXX": khoảng một code point (tương thích file cũ
+//    có input một ký tự);
+//  - "[lo-hi]" với lo, hi là ký tự hoặc "U+XXXX", ví dụ "[a-z]", "[U+0080-U+10FFFF]".
+const uint32_t MAX_CODE_POINT = 0x10FFFF;
+
+struct CodeInterval {
+    uint32_t lo, hi;
+    int target;
+};
+
+struct SymbolicDFA {
+    vector<string> names;
+    map<string, int> name_to_id;
+    int start = -1;
+    vector<char> is_final;
+    vector<string> accept_class; // "" = không có nhãn
+    vector<vector<CodeInterval>> out; // Mỗi trạng thái: các khoảng rời nhau, tăng dần theo lo
+
+    int getStateID(const string& name) {
+        auto it = name_to_id.find(name);
+        if (it != name_to_id.end()) return it->second;
+        names.push_back(name); is_final.push_back(0); accept_class.emplace_back(); out.emplace_back();
+        return name_to_id[name] = (int)names.size() - 1;
+    }
+    size_t intervalCount() const {
+        size_t total = 0;
+        for (const auto& row : out) total += row.size();
+        return total;
+    }
+};
+
+// Đọc một code point tại pos: "U+XXXX" hoặc một ký tự UTF-8
+uint32_t readCodePoint(const string& s, size_t& pos) {
+    if (s.compare(pos, 2, "U+") == 0 && pos + 2 < s.size() && isxdigit((unsigned char)s[pos + 2])) {
+        size_t end = pos + 2;
+        while (end < s.size() && isxdigit((unsigned char)s[end]) && end - pos < 8) end++;
+        uint32_t cp = stoul(s.substr(pos + 2, end - pos - 2), nullptr, 16);
+        pos = end;
+        if (cp > MAX_CODE_POINT) throw runtime_error("Code point vuot qua U+10FFFF: " + s);
+        return cp;
+    }
+    unsigned char c = s[pos];
+    int len = (c < 0x80) ? 1 : (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+    if (len == 0 || pos + len > s.size()) throw runtime_error("Input khong phai UTF-8 hop le: " + s);
+    uint32_t cp = (len == 1) ? c : (c & (0x7F >> len));
+    for (int i = 1; i < len; ++i) cp = (cp << 6) | ((unsigned char)s[pos + i] & 0x3F);
+    pos += len;
+    return cp;
+}
+
+pair<uint32_t, uint32_t> parseInterval(const string& input) {
+    size_t pos = 0;
+    uint32_t lo, hi;
+    if (input.size() > 2 && input.front() == '[' && input.back() == ']') {
+        pos = 1;
+        lo = readCodePoint(input, pos);
+        if (pos >= input.size() || input[pos] != '-') throw runtime_error("Khoang input khong hop le: " + input);
+        pos++;
+        hi = readCodePoint(input, pos);
+        if (pos != input.size() - 1 || lo > hi) throw runtime_error("Khoang input khong hop le: " + input);
+    } else {
+        if (input.empty()) throw runtime_error("Input rong");
+        lo = hi = readCodePoint(input, pos);
+        if (pos != input.size()) throw runtime_error("Input khong phai mot ky tu hoac mot khoang: " + input);
+    }
+    return {lo, hi};
+}
+
+// Ký tự ASCII in được giữ nguyên, còn lại ghi dạng U+XXXX
+string formatCodePoint(uint32_t cp) {
+    if (cp >= 0x21 && cp <= 0x7E) return string(1, (char)cp);
+    char buf[16];
+    snprintf(buf, sizeof(buf), "U+%04X", cp);
+    return buf;
+}
+
+string formatInterval(uint32_t lo, uint32_t hi) {
+    if (lo == hi) return formatCodePoint(lo);
+    return "[" + formatCodePoint(lo) + "-" + formatCodePoint(hi) + "]";
+}
+
+// Sắp xếp khoảng của từng trạng thái, báo lỗi khi chồng nhau (không tất định) và gộp
+// các khoảng liền kề cùng đích
+void normalizeIntervals(SymbolicDFA& dfa) {
+    for (size_t u = 0; u < dfa.out.size(); ++u) {
+        vector<CodeInterval>& row = dfa.out[u];
+        sort(row.begin(), row.end(), [](const CodeInterval& a, const CodeInterval& b) { return a.lo < b.lo; });
+        vector<CodeInterval> merged;
+        for (const CodeInterval& e : row) {
+            if (!merged.empty() && e.lo <= merged.back().hi)
+                throw runtime_error("DFA khong tat dinh: cac khoang chong nhau tai trang thai " + dfa.names[u]);
+            if (!merged.empty() && merged.back().target == e.target && merged.back().hi + 1 == e.lo)
+                merged.back().hi = e.hi;
+            else
+                merged.push_back(e);
+        }
+        row.swap(merged);
+    }
+}
+
+SymbolicDFA loadSymbolicDFA_JSON(string filename) {
+    ifstream f(filename);
+    if (!f.is_open()) throw runtime_error("Khong mo duoc file input: " + filename);
+    json j; f >> j;
+    SymbolicDFA dfa;
     for (auto& item : j) {
-        string s = item["state_name"];
-        dfa.getStateID(s);
-        if (item.value("is_start", false)) dfa.setStart(s);
-        if (item.value("is_end", false)) dfa.addFinal(s);
+        int u = dfa.getStateID(item["state_name"]);
+        if (item.value("is_start", false)) dfa.start = u;
+        if (item.value("is_end", false)) dfa.is_final[u] = 1;
+        if (item.contains("accept_class")) dfa.accept_class[u] = item["accept_class"];
         if (item.contains("transitions")) {
-            for (auto& t : item["transitions"]) 
-                dfa.addTransition(s, t["input"], t["target_state"]);
+            for (auto& t : item["transitions"]) {
+                if (t.contains("output")) throw runtime_error("Che do --symbolic khong ho tro output tren canh");
+                pair<uint32_t, uint32_t> range = parseInterval(t["input"]);
+                int v = dfa.getStateID(t["target_state"]);
+                dfa.out[u].push_back({range.first, range.second, v});
+            }
         }
     }
+    normalizeIntervals(dfa);
+    return dfa;
+}
+
+// Chuyển sang DFA thường với symbol là chuỗi khoảng (đã chuẩn hóa) để dùng lại
+// canonicalizeDFA / exportDFA_JSON / canonicalHash / checkGroundTruth
+DFA toIntervalDFA(const SymbolicDFA& sym) {
+    DFA dfa;
+    for (size_t u = 0; u < sym.names.size(); ++u) {
+        dfa.getStateID(sym.names[u]);
+        if (sym.is_final[u]) dfa.addFinal(sym.names[u]);
+        if (!sym.accept_class[u].empty()) dfa.setAcceptClass(sym.names[u], sym.accept_class[u]);
+        for (const CodeInterval& e : sym.out[u])
+            dfa.addTransition(sym.names[u], formatInterval(e.lo, e.hi), sym.names[e.target]);
+    }
+    if (sym.start != -1) dfa.setStart(sym.names[sym.start]);
     return dfa;
 }
 
-void exportDFA_JSON(const DFA& dfa, string filename) {
+// Hopcroft trên khoảng. Splitter là một khối B (áp dụng cho mọi ký tự cùng lúc); minterm
+// chỉ được tính cục bộ từ các cạnh vào B: quét các đầu mút đã sắp xếp, tập tiền nhiệm
+// pred_a(B) không đổi giữa hai đầu mút liên tiếp. Thay vì tách theo từng pred_a(B)
+// (tốn O(|pred| * số minterm)), tách theo phần thay đổi giữa hai minterm liên tiếp:
+// các tập hiệu đối xứng này sinh ra cùng đại số Bool nên phân hoạch thu được giống hệt,
+// tổng chi phí mỗi splitter là O(e log e) với e = số cạnh vào B.
+class SymbolicHopcroft {
+public:
+    SolverControl control;
+    // Thống kê của lần chạy gần nhất
+    long long splitter_minterms = 0;
+
+    SymbolicDFA minimize(const SymbolicDFA& input) {
+        splitter_minterms = 0;
+        SymbolicDFA result;
+        if (input.start == -1) return result;
+
+        // Trạng thái đạt được, đánh số lại 0..n-1 theo BFS
+        vector<int> id(input.names.size(), -1), states;
+        id[input.start] = 0; states.push_back(input.start);
+        for (size_t i = 0; i < states.size(); ++i)
+            for (const CodeInterval& e : input.out[states[i]])
+                if (id[e.target] == -1) { id[e.target] = (int)states.size(); states.push_back(e.target); }
+        int n = states.size();
+
+        // Cạnh ngược dạng CSR theo đích
+        vector<int> offset(n + 1, 0);
+        for (int u : states) for (const CodeInterval& e : input.out[u]) offset[id[e.target] + 1]++;
+        for (int v = 0; v < n; ++v) offset[v + 1] += offset[v];
+        vector<CodeInterval> preds(offset[n]); // target = trạng thái nguồn
+        {
+            vector<int> fill(offset.begin(), offset.end() - 1);
+            for (int u : states)
+                for (const CodeInterval& e : input.out[u]) preds[fill[id[e.target]]++] = {e.lo, e.hi, id[u]};
+        }
+
+        // Khởi tạo theo nhãn đầu ra (is_end, accept_class), mọi khối vào W
+        map<pair<bool, string>, int> label_ids;
+        for (int u : states) label_ids[{input.is_final[u] != 0, input.accept_class[u]}] = 0;
+        int num_labels = 0;
+        for (auto& p : label_ids) p.second = num_labels++;
+        vector<int> label(n);
+        for (int i = 0; i < n; ++i) label[i] = label_ids[{input.is_final[states[i]] != 0, input.accept_class[states[i]]}];
+        RefinablePartition part;
+        part.init(label, num_labels);
+        for (int b = 0; b < part.blockCount(); ++b) part.push(b);
+
+        SolverProgress progress;
+        vector<pair<uint64_t, int>> events; // (tọa độ, nguồn): vào tại lo, ra tại hi + 1
+        vector<int> toggles(n, 0), X;
+        while (!part.W.empty()) {
+            progress.blocks = part.blockCount();
+            progress.worklist = part.W.size();
+            control.poll(progress);
+            progress.rounds++;
+            int b = part.pop();
+            events.clear();
+            for (int i = part.first[b]; i < part.last[b]; ++i) {
+                int v = part.elements[i];
+                for (int p = offset[v]; p < offset[v + 1]; ++p) {
+                    events.push_back({preds[p].lo, preds[p].target});
+                    events.push_back({(uint64_t)preds[p].hi + 1, preds[p].target});
+                }
+            }
+            sort(events.begin(), events.end());
+            for (size_t i = 0; i < events.size();) {
+                size_t j = i;
+                for (; j < events.size() && events[j].first == events[i].first; ++j) toggles[events[j].second] ^= 1;
+                // Nguồn rời một khoảng và vào khoảng kế tiếp (cùng vào B) ở cùng tọa độ: không đổi
+                X.clear();
+                for (size_t e = i; e < j; ++e) {
+                    int u = events[e].second;
+                    if (toggles[u]) { X.push_back(u); toggles[u] = 0; }
+                }
+                if (!X.empty()) { part.splitBy(X); splitter_minterms++; }
+                i = j;
+            }
+        }
+
+        // Dựng DFA tối thiểu theo thứ tự khối, tên trạng thái "{A,B,...}"
+        int blocks = part.blockCount();
+        vector<int> rep(blocks);
+        for (int blk = 0; blk < blocks; ++blk) {
+            vector<string> members;
+            bool is_f = false;
+            for (int i = part.first[blk]; i < part.last[blk]; ++i) {
+                members.push_back(input.names[states[part.elements[i]]]);
+                is_f = is_f || input.is_final[states[part.elements[i]]];
+            }
+            sort(members.begin(), members.end());
+            string name = "{";
+            for (size_t i = 0; i < members.size(); ++i) name += (i == 0 ? "" : ",") + members[i];
+            name += "}";
+            result.getStateID(name);
+            result.is_final[blk] = is_f;
+            result.accept_class[blk] = input.accept_class[states[part.elements[part.first[blk]]]];
+            rep[blk] = states[part.elements[part.first[blk]]];
+        }
+        result.start = part.block[0];
+        for (int blk = 0; blk < blocks; ++blk)
+            for (const CodeInterval& e : input.out[rep[blk]])
+                result.out[blk].push_back({e.lo, e.hi, part.block[id[e.target]]});
+        normalizeIntervals(result);
+        return result;
+    }
+};
+
+// === PHẦN 2e: BISIMULATION TRÊN NFA / LTS (PAIGE-TARJAN) ===
+// DFA::addTransition ghi đè transitions[u][c], nên input không tất định không đọc được
+// bằng loadDFA_JSON. LTS giữ mọi cạnh (u, nhãn, v); nhãn là cặp (input, output) để cạnh
+// Mealy cũng dùng được. Nhiều trạng thái có thể là is_start.
+struct LTSEdge {
+    int from, label, to;
+    bool operator<(const LTSEdge& o) const {
+        return tie(from, label, to) < tie(o.from, o.label, o.to);
+    }
+    bool operator==(const LTSEdge& o) const {
+        return from == o.from && label == o.label && to == o.to;
+    }
+};
+
+struct LTS {
+    vector<string> names;
+    map<string, int> name_to_id;
+    vector<char> is_start, is_final;
+    vector<string> accept_class; // "" = không có nhãn
+    vector<pair<string, string>> labels; // (input, output), output "" = không có
+    map<pair<string, string>, int> label_ids;
+    vector<LTSEdge> edges; // Sắp xếp theo (from, label, to), không trùng lặp
+
+    int getStateID(const string& name) {
+        auto it = name_to_id.find(name);
+        if (it != name_to_id.end()) return it->second;
+        names.push_back(name); is_start.push_back(0); is_final.push_back(0); accept_class.emplace_back();
+        return name_to_id[name] = (int)names.size() - 1;
+    }
+    int getLabelID(const string& input, const string& output) {
+        auto it = label_ids.find({input, output});
+        if (it != label_ids.end()) return it->second;
+        labels.push_back({input, output});
+        return label_ids[{input, output}] = (int)labels.size() - 1;
+    }
+    void normalize() {
+        sort(edges.begin(), edges.end());
+        edges.erase(unique(edges.begin(), edges.end()), edges.end());
+    }
+};
+
+LTS loadLTS_JSON(string filename) {
+    ifstream f(filename);
+    if (!f.is_open()) throw runtime_error("Khong mo duoc file input: " + filename);
+    json j; f >> j;
+    LTS lts;
+    for (auto& item : j) {
+        int u = lts.getStateID(item["state_name"]);
+        if (item.value("is_start", false)) lts.is_start[u] = 1;
+        if (item.value("is_end", false)) lts.is_final[u] = 1;
+        if (item.contains("accept_class")) lts.accept_class[u] = item["accept_class"];
+        if (item.contains("transitions")) {
+            for (auto& t : item["transitions"]) {
+                int a = lts.getLabelID(t["input"], t.value("output", ""));
+                lts.edges.push_back({u, a, lts.getStateID(t["target_state"])});
+            }
+        }
+    }
+    lts.normalize();
+    return lts;
+}
+
+void exportLTS_JSON(const LTS& lts, string filename) {
     json j_out = json::array();
-    for (int u : dfa.states) {
+    size_t e = 0;
+    for (size_t u = 0; u < lts.names.size(); ++u) {
         json j_s;
-        j_s["state_name"] = dfa.state_id_to_name.at(u);
-        j_s["is_start"] = (u == dfa.start_state);
-        j_s["is_end"] = (dfa.final_states.count(u) > 0);
+        j_s["state_name"] = lts.names[u];
+        j_s["is_start"] = lts.is_start[u] != 0;
+        j_s["is_end"] = lts.is_final[u] != 0;
+        if (!lts.accept_class[u].empty()) j_s["accept_class"] = lts.accept_class[u];
         json j_trans = json::array();
-        if (dfa.transitions.count(u)) {
-            for (auto const& p : dfa.transitions.at(u)) {
-                json t;
-                t["input"] = dfa.input_id_to_char.at(p.first);
-                t["target_state"] = dfa.state_id_to_name.at(p.second);
-                j_trans.push_back(t);
-            }
+        for (; e < lts.edges.size() && lts.edges[e].from == (int)u; ++e) {
+            json t;
+            t["input"] = lts.labels[lts.edges[e].label].first;
+            t["target_state"] = lts.names[lts.edges[e].to];
+            if (!lts.labels[lts.edges[e].label].second.empty()) t["output"] = lts.labels[lts.edges[e].label].second;
+            j_trans.push_back(t);
         }
         j_s["transitions"] = j_trans;
         j_out.push_back(j_s);
@@ -101,192 +1149,949 @@ void exportDFA_JSON(const DFA& dfa, string filename) {
     ofstream o(filename); o << std::setw(4) << j_out;
 }
 
-// === PHẦN 2: LOGIC HOPCROFT ===
-class Solver {
-private:
-    DFA removeUnreachable(const DFA& dfa) {
-        DFA clean = dfa; 
-        set<int> reachable; queue<int> q;
-        if (dfa.start_state == -1) return clean; 
-        q.push(dfa.start_state); reachable.insert(dfa.start_state);
-        while(!q.empty()) {
-            int u = q.front(); q.pop();
-            if (dfa.transitions.count(u)) {
-                for (auto const& p : dfa.transitions.at(u)) {
-                    if (!reachable.count(p.second)) {
-                        reachable.insert(p.second); q.push(p.second);
-                    }
+// Phân hoạch thô nhất ổn định (bisimulation mạnh) theo Paige-Tarjan. Ngoài phân hoạch P
+// (RefinablePartition) còn giữ phân hoạch thô X: mỗi khối hợp của X là hợp các khối của P
+// và P luôn ổn định với X. Mỗi bước lấy khối B nhỏ hơn (<= |C| / 2) của một khối hợp C,
+// tách B ra thành khối hợp riêng rồi tách ba chiều mọi khối theo từng nhãn a:
+// ngoài pre_a(B), chỉ vào B (count(s, a, B) == count(s, a, C)), vào cả B lẫn C \ B.
+// count(s, a, C) được lưu trong một bản ghi dùng chung bởi các cạnh s --a--> C, nên
+// không phải duyệt C \ B. Mỗi cạnh được duyệt O(log n) lần: O(m log n), bộ nhớ O(n + m).
+class PaigeTarjan {
+public:
+    SolverControl control;
+    // Thống kê của lần chạy gần nhất
+    long long splitter_blocks = 0;
+
+    LTS minimize(const LTS& input) {
+        splitter_blocks = 0;
+        LTS result;
+        result.labels = input.labels;
+        result.label_ids = input.label_ids;
+
+        // Trạng thái đạt được từ mọi trạng thái bắt đầu, đánh số lại 0..n-1 theo BFS
+        int total = input.names.size();
+        vector<int> out_offset(total + 1, 0);
+        for (const LTSEdge& e : input.edges) out_offset[e.from + 1]++;
+        for (int u = 0; u < total; ++u) out_offset[u + 1] += out_offset[u];
+        vector<int> id(total, -1), states;
+        for (int u = 0; u < total; ++u)
+            if (input.is_start[u]) { id[u] = (int)states.size(); states.push_back(u); }
+        for (size_t i = 0; i < states.size(); ++i)
+            for (int p = out_offset[states[i]]; p < out_offset[states[i] + 1]; ++p)
+                if (id[input.edges[p].to] == -1) { id[input.edges[p].to] = (int)states.size(); states.push_back(input.edges[p].to); }
+        int n = states.size();
+        if (n == 0) return result;
+
+        // Cạnh giữa các trạng thái đạt được, vẫn sắp theo (from, label) vì duyệt theo id
+        vector<LTSEdge> E;
+        for (int u : states)
+            for (int p = out_offset[u]; p < out_offset[u + 1]; ++p)
+                E.push_back({id[u], input.edges[p].label, id[input.edges[p].to]});
+        int m = E.size();
+        vector<int> in_offset(n + 1, 0), in_edges(m);
+        for (const LTSEdge& e : E) in_offset[e.to + 1]++;
+        for (int v = 0; v < n; ++v) in_offset[v + 1] += in_offset[v];
+        {
+            vector<int> fill(in_offset.begin(), in_offset.end() - 1);
+            for (int e = 0; e < m; ++e) in_edges[fill[E[e].to]++] = e;
+        }
+
+        // Khởi tạo theo nhãn đầu ra (is_end, accept_class)
+        map<pair<bool, string>, int> label_ids;
+        for (int u : states) label_ids[{input.is_final[u] != 0, input.accept_class[u]}] = 0;
+        int num_labels = 0;
+        for (auto& p : label_ids) p.second = num_labels++;
+        vector<int> label(n);
+        for (int i = 0; i < n; ++i) label[i] = label_ids[{input.is_final[states[i]] != 0, input.accept_class[states[i]]}];
+        RefinablePartition part;
+        part.init(label, num_labels);
+
+        // Khối hợp: cblocks[c] là các khối của P trong c, cidx[b] là vị trí của b trong đó
+        vector<vector<int>> cblocks(1);
+        vector<int> cof, cidx, pending; // pending: khối hợp có >= 2 khối
+        vector<char> in_pending(1, 0);
+        int known_blocks = 0;
+        // Khối mới do splitBy tạo chiếm [first[b], split) ngay trước khối cha b
+        auto registerBlocks = [&]() {
+            for (int nb = known_blocks; nb < part.blockCount(); ++nb) {
+                int c = (nb < num_labels) ? 0 : cof[part.block[part.elements[part.last[nb]]]];
+                cof.push_back(c); cidx.push_back((int)cblocks[c].size());
+                cblocks[c].push_back(nb);
+                if (cblocks[c].size() >= 2 && !in_pending[c]) { in_pending[c] = 1; pending.push_back(c); }
+            }
+            known_blocks = part.blockCount();
+        };
+        registerBlocks();
+
+        // P ổn định với X = {Q}: tách theo pre_a(Q) với mọi nhãn a. count(s, a, Q) là
+        // số cạnh s --a-->, mỗi nhóm (s, a) liên tiếp trong E dùng chung một bản ghi.
+        int k = input.labels.size();
+        vector<vector<int>> by_label(k);
+        vector<int> count_value, cnt(m), free_records;
+        for (int e = 0; e < m; ++e) {
+            if (e == 0 || E[e].from != E[e - 1].from || E[e].label != E[e - 1].label) {
+                count_value.push_back(0);
+                by_label[E[e].label].push_back(E[e].from);
+            }
+            cnt[e] = (int)count_value.size() - 1;
+            count_value.back()++;
+        }
+        for (int a = 0; a < k; ++a) {
+            if (!by_label[a].empty()) { part.splitBy(by_label[a]); registerBlocks(); }
+            by_label[a].clear();
+        }
+
+        SolverProgress progress;
+        vector<int> members, touched_labels, X, Y;
+        vector<int> count_b(n, 0), record_c(n, -1);
+        while (!pending.empty()) {
+            progress.blocks = part.blockCount();
+            progress.worklist = pending.size();
+            control.poll(progress);
+            progress.rounds++;
+            int c = pending.back();
+            // B: khối nhỏ hơn trong hai khối đầu của c, nên |B| <= |C| / 2
+            int b = cblocks[c][0], other = cblocks[c][1];
+            if (part.blockSize(other) < part.blockSize(b)) b = other;
+            int last_block = cblocks[c].back();
+            cblocks[c][cidx[b]] = last_block; cidx[last_block] = cidx[b];
+            cblocks[c].pop_back();
+            if (cblocks[c].size() < 2) { in_pending[c] = 0; pending.pop_back(); }
+            cof[b] = (int)cblocks.size(); cidx[b] = 0;
+            cblocks.push_back({b}); in_pending.push_back(0);
+            splitter_blocks++;
+
+            // Cạnh vào B, gom theo nhãn (B có thể bị tách trong lúc xử lý nên chép trước)
+            members.assign(part.elements.begin() + part.first[b], part.elements.begin() + part.last[b]);
+            for (int v : members)
+                for (int p = in_offset[v]; p < in_offset[v + 1]; ++p) {
+                    int e = in_edges[p];
+                    if (by_label[E[e].label].empty()) touched_labels.push_back(E[e].label);
+                    by_label[E[e].label].push_back(e);
+                }
+            for (int a : touched_labels) {
+                X.clear(); Y.clear();
+                for (int e : by_label[a]) {
+                    int s = E[e].from;
+                    if (count_b[s]++ == 0) { X.push_back(s); record_c[s] = cnt[e]; }
                 }
+                for (int s : X) if (count_b[s] == count_value[record_c[s]]) Y.push_back(s);
+                part.splitBy(X); registerBlocks();
+                if (!Y.empty()) { part.splitBy(Y); registerBlocks(); }
+
+                // count(s, a, C \ B) giữ bản ghi cũ, count(s, a, B) sang bản ghi mới;
+                // bản ghi về 0 được dùng lại nên số bản ghi luôn <= m
+                for (int s : X) {
+                    int old = record_c[s];
+                    count_value[old] -= count_b[s];
+                    int r;
+                    if (!free_records.empty()) { r = free_records.back(); free_records.pop_back(); count_value[r] = count_b[s]; }
+                    else { r = (int)count_value.size(); count_value.push_back(count_b[s]); }
+                    if (count_value[old] == 0) free_records.push_back(old);
+                    record_c[s] = r;
+                }
+                for (int e : by_label[a]) cnt[e] = record_c[E[e].from];
+                for (int s : X) { count_b[s] = 0; record_c[s] = -1; }
+                by_label[a].clear();
+            }
+            touched_labels.clear();
+        }
+
+        // Dựng LTS thương theo thứ tự BFS của trạng thái nhỏ nhất trong khối,
+        // tên trạng thái "{A,B,...}"
+        int blocks = part.blockCount();
+        vector<int> min_state(blocks, n), order(blocks), new_id(blocks);
+        for (int i = 0; i < n; ++i) min_state[part.block[i]] = min(min_state[part.block[i]], i);
+        for (int blk = 0; blk < blocks; ++blk) order[blk] = blk;
+        sort(order.begin(), order.end(), [&](int x, int y) { return min_state[x] < min_state[y]; });
+        for (int i = 0; i < blocks; ++i) new_id[order[i]] = i;
+        for (int blk : order) {
+            vector<string> members_names;
+            bool start = false;
+            for (int i = part.first[blk]; i < part.last[blk]; ++i) {
+                members_names.push_back(input.names[states[part.elements[i]]]);
+                start = start || input.is_start[states[part.elements[i]]];
             }
+            sort(members_names.begin(), members_names.end());
+            string name = "{";
+            for (size_t i = 0; i < members_names.size(); ++i) name += (i == 0 ? "" : ",") + members_names[i];
+            name += "}";
+            int u = result.getStateID(name);
+            int rep = states[min_state[blk]];
+            result.is_start[u] = start;
+            result.is_final[u] = input.is_final[rep];
+            result.accept_class[u] = input.accept_class[rep];
         }
-        clean.states = reachable;
-        set<int> new_finals;
-        for(int s : reachable) if(dfa.final_states.count(s)) new_finals.insert(s);
-        clean.final_states = new_finals;
-        return clean;
+        // Trạng thái trong cùng khối bisimilar nên cạnh của đại diện là đủ
+        for (const LTSEdge& e : E)
+            if (e.from == min_state[part.block[e.from]])
+                result.edges.push_back({new_id[part.block[e.from]], e.label, new_id[part.block[e.to]]});
+        result.normalize();
+        return result;
     }
+};
 
+// === PHẦN 2f: RÚT GỌN NFA THEO QUAN HỆ MÔ PHỎNG (TRƯỚC KHI TẤT ĐỊNH HÓA) ===
+// Tiền mô phỏng lớn nhất theo kiểu phân hoạch - quan hệ (Henzinger-Henzinger-Kopke nâng lên
+// khối như Ranzato-Tapparo): phân hoạch P gom các trạng thái chưa phân biệt được, rel là quan
+// hệ trên khối (bit-packed): rel[B] chứa C khi mọi trạng thái của C (còn) có thể mô phỏng mọi
+// trạng thái của B. remove[D] giữ các khe (x, a) (trạng thái x có cạnh a) vừa mất cạnh a
+// cuối cùng vào hợp rel[D], tức x không còn thuộc pre_a(hợp rel[D]). Lần đầu xử lý D quét
+// cạnh vào của hợp rel[D] một lần (như bản phân hoạch - quan hệ gốc); từ đó D chỉ được xử lý
+// lại khi remove[D] khác rỗng, theo từng nhãn a:
+//  - tách P theo remove_a rồi theo pre_a(D);
+//  - với khối C nằm trong pre_a(D), xóa khỏi rel[C] các khối E nằm trong remove_a; mỗi khe
+//    có cạnh vào E được kiểm tra lại trên cạnh ra của nó, hết đích trong hợp rel[C] thì
+//    vào remove[C].
+// Mỗi cặp (C, E) bị xóa khỏi rel đúng một lần, nên công cập nhật remove tỉ lệ với số cặp
+// bị xóa thay vì quét lại cạnh vào của hợp rel[D] ở mỗi lượt. Khi C mất phần lớn hàng rel
+// cùng lúc, C được đưa về lần đầu (quét lại một lần rẻ hơn kiểm tra từng khối bị xóa).
+// Bộ nhớ O(|P|^2 / 64) word.
+class SimulationPreorder {
 public:
-    DFA minimize(DFA inputDFA) {
-        DFA dfa = removeUnreachable(inputDFA);
-        if (dfa.states.empty()) return dfa;
-
-        set<set<int>> P;
-        set<int> non_finals;
-        for(int s : dfa.states) if(!dfa.final_states.count(s)) non_finals.insert(s);
-        if(!dfa.final_states.empty()) P.insert(dfa.final_states);
-        if(!non_finals.empty()) P.insert(non_finals);
-        
-        set<set<int>> W = P;
-        map<int, map<int, set<int>>> inv;
-        for(int u : dfa.states)
-            for(auto const& p : dfa.transitions[u]) inv[p.second][p.first].insert(u);
-
-        while(!W.empty()) {
-            set<int> A = *W.begin(); W.erase(W.begin());
-            for(int c : dfa.alphabet) {
-                set<int> X;
-                for(int u : A) for(int pre : inv[u][c]) X.insert(pre);
-                if(X.empty()) continue;
-
-                vector<set<int>> rem;
-                vector<pair<set<int>, set<int>>> add;
-                for(const set<int>& Y : P) {
-                    set<int> i, d;
-                    set_intersection(Y.begin(), Y.end(), X.begin(), X.end(), inserter(i, i.begin()));
-                    set_difference(Y.begin(), Y.end(), X.begin(), X.end(), inserter(d, d.begin()));
-                    if(!i.empty() && !d.empty()) {
-                        rem.push_back(Y); add.push_back({i, d});
-                        if(W.count(Y)) { W.erase(Y); W.insert(i); W.insert(d); }
-                        else { if(i.size() <= d.size()) W.insert(i); else W.insert(d); }
+    RefinablePartition part;
+    vector<vector<uint64_t>> rel;
+    long long splitter_rounds = 0;
+
+    bool leqBlocks(int b, int c) const { return (rel[b][c >> 6] >> (c & 63)) & 1; }
+    bool leq(int p, int q) const { return leqBlocks(part.block[p], part.block[q]); }
+
+    // label: nhãn khởi tạo trong [0, num_labels), mọi nhãn có ít nhất một trạng thái;
+    // compatible(l1, l2): trạng thái nhãn l2 được phép mô phỏng trạng thái nhãn l1
+    void compute(int n, const vector<LTSEdge>& E, int k, const vector<int>& label, int num_labels,
+                 const function<bool(int, int)>& compatible, SolverControl& control) {
+        int m = E.size();
+        in_offset.assign(n + 1, 0);
+        in_edges.assign(m, 0);
+        for (const LTSEdge& e : E) in_offset[e.to + 1]++;
+        for (int v = 0; v < n; ++v) in_offset[v + 1] += in_offset[v];
+        {
+            vector<int> fill(in_offset.begin(), in_offset.end() - 1);
+            for (int e = 0; e < m; ++e) in_edges[fill[E[e].to]++] = e;
+        }
+        // Khe (x, a): gom các cạnh cùng nguồn, cùng nhãn
+        vector<int> by_source(m);
+        for (int e = 0; e < m; ++e) by_source[e] = e;
+        sort(by_source.begin(), by_source.end(), [&](int x, int y) {
+            return tie(E[x].from, E[x].label) < tie(E[y].from, E[y].label);
+        });
+        slot_of.assign(m, 0);
+        slot_state.clear(); slot_label.clear(); slot_first.clear(); slot_targets.assign(m, 0);
+        for (int i = 0; i < m; ++i) {
+            const LTSEdge& e = E[by_source[i]];
+            if (i == 0 || e.from != E[by_source[i - 1]].from || e.label != E[by_source[i - 1]].label) {
+                slot_state.push_back(e.from); slot_label.push_back(e.label); slot_first.push_back(i);
+            }
+            slot_of[by_source[i]] = (int)slot_state.size() - 1;
+            slot_targets[i] = e.to;
+        }
+        int S = slot_state.size();
+        slot_first.push_back(m);
+
+        // Trạng thái có cạnh a chỉ được mô phỏng bởi trạng thái có cạnh a: tách sẵn theo
+        // pre_a(Q) để điều kiện này nằm trên khối
+        part.init(label, num_labels);
+        {
+            vector<vector<int>> with_label(k);
+            for (int s = 0; s < S; ++s) with_label[slot_label[s]].push_back(slot_state[s]);
+            for (int a = 0; a < k; ++a) if (!with_label[a].empty()) part.splitBy(with_label[a]);
+        }
+        int B = part.blockCount();
+        vector<vector<int>> labels_of(B);
+        for (int s = 0; s < S; ++s) {
+            int b = part.block[slot_state[s]];
+            if (part.elements[part.first[b]] == slot_state[s]) labels_of[b].push_back(slot_label[s]);
+        }
+        words = max<size_t>(1, (B + 63) / 64);
+        rel.assign(B, vector<uint64_t>(words, 0));
+        for (int b = 0; b < B; ++b) {
+            int lb = label[part.elements[part.first[b]]];
+            for (int c = 0; c < B; ++c)
+                if (compatible(lb, label[part.elements[part.first[c]]]) &&
+                    includes(labels_of[c].begin(), labels_of[c].end(), labels_of[b].begin(), labels_of[b].end()))
+                    rel[b][c >> 6] |= 1ULL << (c & 63);
+        }
+        known_blocks = B;
+
+        remove.assign(B, vector<int>());
+        ready.assign(B, 0);
+        in_queue.assign(B, 0);
+        pending = queue<int>();
+        for (int d = 0; d < B; ++d) enqueue(d);
+
+        SolverProgress progress;
+        vector<vector<int>> pre(k), split(k);
+        vector<int> members, labels, rem, seen(n, -1), C;
+        vector<uint64_t> kill;
+        checked.assign(S, -1);
+        int tick = 0;
+        splitter_rounds = 0;
+        while (!pending.empty()) {
+            progress.blocks = part.blockCount();
+            progress.worklist = pending.size();
+            control.poll(progress);
+            int d = pending.front(); pending.pop(); in_queue[d] = 0;
+            bool first_pass = !ready[d];
+            rem.clear();
+            rem.swap(remove[d]);
+            if (!first_pass && rem.empty()) continue;
+            ready[d] = 1;
+            progress.rounds++;
+            splitter_rounds++;
+
+            // pre_a(D) theo từng nhãn (trên tập thành viên lúc bắt đầu, D có thể bị tách)
+            members.assign(part.elements.begin() + part.first[d], part.elements.begin() + part.last[d]);
+            for (int v : members)
+                for (int p = in_offset[v]; p < in_offset[v + 1]; ++p) {
+                    const LTSEdge& e = E[in_edges[p]];
+                    pre[e.label].push_back(e.from);
+                }
+            if (first_pass) {
+                // Lần đầu: split_a = pre_a(hợp rel[D]), giữ lại trong rel[C] các khối thuộc đó
+                for (size_t w = 0; w < words; ++w)
+                    for (uint64_t bits = rel[d][w]; bits; bits &= bits - 1) {
+                        int b = (int)(w * 64 + __builtin_ctzll(bits));
+                        for (int i = part.first[b]; i < part.last[b]; ++i)
+                            for (int p = in_offset[part.elements[i]]; p < in_offset[part.elements[i] + 1]; ++p) {
+                                const LTSEdge& e = E[in_edges[p]];
+                                if (!pre[e.label].empty()) split[e.label].push_back(e.from);
+                            }
                     }
+                for (int a = 0; a < k; ++a) if (!pre[a].empty()) labels.push_back(a);
+            } else {
+                // Các lần sau: split_a = các khe vừa mất đích, xóa khỏi rel[C] các khối thuộc đó
+                for (int x : rem) {
+                    int a = slot_label[x];
+                    if (split[a].empty() && !pre[a].empty()) labels.push_back(a);
+                    split[a].push_back(slot_state[x]);
                 }
-                for(auto& r : rem) P.erase(r);
-                for(auto& a : add) { P.insert(a.first); P.insert(a.second); }
             }
+
+            for (int a : labels) {
+                dedup(pre[a], seen, tick);
+                dedup(split[a], seen, tick);
+                part.splitBy(split[a]); registerBlocks();
+                part.splitBy(pre[a]); registerBlocks();
+
+                kill.assign(words, first_pass ? ~0ULL : 0);
+                for (int u : split[a]) {
+                    uint64_t bit = 1ULL << (part.block[u] & 63);
+                    if (first_pass) kill[part.block[u] >> 6] &= ~bit;
+                    else kill[part.block[u] >> 6] |= bit;
+                }
+                C.clear();
+                ++tick;
+                for (int u : pre[a]) {
+                    int c = part.block[u];
+                    if (seen[c] != tick) { seen[c] = tick; C.push_back(c); }
+                }
+                for (int c : C) {
+                    size_t dropped = 0, kept = 0;
+                    for (size_t w = 0; w < words; ++w) {
+                        dropped += __builtin_popcountll(rel[c][w] & kill[w]);
+                        kept += __builtin_popcountll(rel[c][w] & ~kill[w]);
+                    }
+                    if (!dropped) continue;
+                    if (ready[c] && dropped * 4 > kept) {
+                        // Mất phần lớn rel[C]: tính lại C từ đầu rẻ hơn kiểm tra từng khối bị xóa
+                        for (size_t w = 0; w < words; ++w) rel[c][w] &= ~kill[w];
+                        ready[c] = 0;
+                        remove[c].clear();
+                        enqueue(c);
+                        continue;
+                    }
+                    for (size_t w = 0; w < words; ++w)
+                        for (uint64_t bits = rel[c][w] & kill[w]; bits; bits &= bits - 1)
+                            removeRel(c, (int)(w * 64 + __builtin_ctzll(bits)));
+                }
+            }
+            for (int a = 0; a < k; ++a) { pre[a].clear(); split[a].clear(); }
+            labels.clear();
         }
-        
-        // Tái tạo DFA
-        DFA minDFA;
-        minDFA.input_char_to_id = dfa.input_char_to_id;
-        minDFA.input_id_to_char = dfa.input_id_to_char;
-        minDFA.alphabet = dfa.alphabet;
-        map<int, string> mapping;
-        map<string, int> rep_map;
-        for(const set<int>& g : P) {
-            string name = "{"; 
-            int rep = *g.begin();
-            bool is_s = false, is_f = false;
-            vector<string> nlist;
-            for(int s : g) {
-                nlist.push_back(dfa.state_id_to_name.at(s));
-                if(s == dfa.start_state) is_s = true;
-                if(dfa.final_states.count(s)) is_f = true;
-            }
-            sort(nlist.begin(), nlist.end());
-            for(size_t i=0; i<nlist.size(); ++i) name += (i==0?"":",") + nlist[i];
+    }
+
+private:
+    size_t words = 0;
+    int known_blocks = 0;
+    vector<int> in_offset, in_edges;
+    // Khe s gồm các cạnh slot_targets[slot_first[s] .. slot_first[s + 1]) cùng nguồn, cùng nhãn
+    vector<int> slot_of, slot_state, slot_label, slot_first, slot_targets;
+    vector<vector<int>> remove; // Khe vừa hết đích trong hợp rel[D], chờ xử lý khi lấy D ra
+    vector<char> ready;         // Khối đã qua lần xử lý đầu (từ đó chỉ cập nhật qua remove)
+    vector<int> checked;
+    int check_tick = 0;
+    queue<int> pending;         // FIFO: hàng rel kịp thu nhỏ trước khi khối được xử lý lại
+    vector<char> in_queue;
+
+    void enqueue(int b) { if (!in_queue[b]) { in_queue[b] = 1; pending.push(b); } }
+
+    // Xóa E khỏi rel[C]; khe có cạnh vào E mà hết đích trong hợp rel[C] thì vào remove[C]
+    // (khối chưa qua lần đầu sẽ tự tính lại từ rel[C])
+    void removeRel(int c, int r) {
+        rel[c][r >> 6] &= ~(1ULL << (r & 63));
+        if (!ready[c]) return;
+        ++check_tick;
+        for (int i = part.first[r]; i < part.last[r]; ++i) {
+            int v = part.elements[i];
+            for (int p = in_offset[v]; p < in_offset[v + 1]; ++p) {
+                int x = slot_of[in_edges[p]];
+                if (checked[x] == check_tick) continue;
+                checked[x] = check_tick;
+                if (!reaches(c, x)) { remove[c].push_back(x); enqueue(c); }
+            }
+        }
+    }
+
+    // Khe s còn cạnh vào hợp rel[d]
+    bool reaches(int d, int s) const {
+        for (int i = slot_first[s]; i < slot_first[s + 1]; ++i)
+            if (leqBlocks(d, part.block[slot_targets[i]])) return true;
+        return false;
+    }
+
+    static void dedup(vector<int>& xs, vector<int>& seen, int& tick) {
+        ++tick;
+        size_t out = 0;
+        for (int x : xs) if (seen[x] != tick) { seen[x] = tick; xs[out++] = x; }
+        xs.resize(out);
+    }
+
+    // Khối mới do splitBy tạo chiếm [first[b], split) ngay trước khối cha b: chép hàng,
+    // cột và remove của cha (cùng tập mô phỏng nên cùng các khe đã mất đích)
+    void registerBlocks() {
+        for (int nb = known_blocks; nb < part.blockCount(); ++nb) {
+            int parent = part.block[part.elements[part.last[nb]]];
+            if ((size_t)nb >= words * 64) {
+                words *= 2;
+                for (auto& row : rel) row.resize(words, 0);
+            }
+            rel.push_back(rel[parent]);
+            for (auto& row : rel)
+                if ((row[parent >> 6] >> (parent & 63)) & 1) row[nb >> 6] |= 1ULL << (nb & 63);
+            remove.push_back(remove[parent]);
+            ready.push_back(ready[parent]);
+            in_queue.push_back(0);
+            if (!ready[nb] || !remove[nb].empty()) enqueue(nb);
+        }
+        known_blocks = part.blockCount();
+    }
+};
+
+// Rút gọn NFA bảo toàn ngôn ngữ trước khi tất định hóa. Mỗi lượt:
+//  - mô phỏng tiến (p ⊑ q: q kết thúc nếu p kết thúc, cùng accept_class): gộp các trạng
+//    thái tương đương mô phỏng, bỏ cạnh p --a--> r khi có p --a--> r' với r ⊏ r', bỏ trạng
+//    thái bắt đầu bị một trạng thái bắt đầu khác mô phỏng chặt;
+//  - mô phỏng lùi trên NFA đảo (cùng is_end / accept_class, q bắt đầu nếu p bắt đầu):
+//    gộp như trên, bỏ cạnh r --a--> p khi có r' --a--> p với r ⊏ r';
+//  - bỏ trạng thái không đạt được / không tới được trạng thái kết thúc.
+// Lặp tới khi không đổi. Cạnh có output bị coi như nhãn (input, output).
+class SimulationReducer {
+public:
+    SolverControl control;
+    // Thống kê của lần chạy gần nhất
+    int passes = 0;
+    long long splitter_rounds = 0;
+    size_t pruned_transitions = 0;
+
+    LTS reduce(const LTS& input) {
+        passes = 0; splitter_rounds = 0; pruned_transitions = 0;
+        Work w;
+        int total = input.names.size();
+        w.members.resize(total);
+        for (int u = 0; u < total; ++u) w.members[u] = {u};
+        w.is_start.assign(input.is_start.begin(), input.is_start.end());
+        w.is_final.assign(input.is_final.begin(), input.is_final.end());
+        w.accept_class = input.accept_class;
+        w.edges = input.edges;
+        w.k = input.labels.size();
+        trim(w);
+        while (true) {
+            passes++;
+            size_t states = w.members.size(), edges = w.edges.size(), starts = count(w.is_start.begin(), w.is_start.end(), 1);
+            step(w, false);
+            step(w, true);
+            trim(w);
+            if (w.members.size() == states && w.edges.size() == edges &&
+                (size_t)count(w.is_start.begin(), w.is_start.end(), 1) == starts) break;
+        }
+
+        LTS result;
+        result.labels = input.labels;
+        result.label_ids = input.label_ids;
+        for (size_t u = 0; u < w.members.size(); ++u) {
+            vector<string> names;
+            for (int x : w.members[u]) names.push_back(input.names[x]);
+            sort(names.begin(), names.end());
+            string name = "{";
+            for (size_t i = 0; i < names.size(); ++i) name += (i == 0 ? "" : ",") + names[i];
             name += "}";
-            minDFA.getStateID(name);
-            if(is_s) minDFA.setStart(name);
-            if(is_f) minDFA.addFinal(name);
-            rep_map[name] = rep;
-            for(int s : g) mapping[s] = name;
-        }
-        for(auto const& pair : rep_map) {
-            if(dfa.transitions.count(pair.second)) {
-                for(auto const& t : dfa.transitions.at(pair.second)) {
-                    minDFA.addTransition(pair.first, minDFA.input_id_to_char[t.first], mapping[t.second]);
-                }
+            int id = result.getStateID(name);
+            result.is_start[id] = w.is_start[u];
+            result.is_final[id] = w.is_final[u];
+            result.accept_class[id] = w.accept_class[u];
+        }
+        result.edges = w.edges;
+        result.normalize();
+        return result;
+    }
+
+private:
+    struct Work {
+        vector<vector<int>> members; // Trạng thái gốc của mỗi trạng thái hiện tại
+        vector<char> is_start, is_final;
+        vector<string> accept_class;
+        vector<LTSEdge> edges;
+        int k = 0;
+    };
+
+    // Giữ trạng thái đạt được từ trạng thái bắt đầu và tới được trạng thái kết thúc
+    // (trạng thái bắt đầu luôn được giữ), đánh số lại theo thứ tự cũ
+    void trim(Work& w) {
+        int n = w.members.size();
+        vector<vector<int>> succ(n), pred(n);
+        for (const LTSEdge& e : w.edges) { succ[e.from].push_back(e.to); pred[e.to].push_back(e.from); }
+        vector<char> fwd(n, 0), bwd(n, 0);
+        vector<int> stack;
+        for (int u = 0; u < n; ++u) if (w.is_start[u]) { fwd[u] = 1; stack.push_back(u); }
+        while (!stack.empty()) {
+            int u = stack.back(); stack.pop_back();
+            for (int v : succ[u]) if (!fwd[v]) { fwd[v] = 1; stack.push_back(v); }
+        }
+        for (int u = 0; u < n; ++u) if (w.is_final[u]) { bwd[u] = 1; stack.push_back(u); }
+        while (!stack.empty()) {
+            int u = stack.back(); stack.pop_back();
+            for (int v : pred[u]) if (!bwd[v]) { bwd[v] = 1; stack.push_back(v); }
+        }
+        vector<int> id(n, -1);
+        int kept = 0;
+        for (int u = 0; u < n; ++u) if (fwd[u] && (bwd[u] || w.is_start[u])) id[u] = kept++;
+        vector<int> order(kept);
+        for (int u = 0; u < n; ++u) if (id[u] != -1) order[id[u]] = u;
+        remap(w, id, order);
+    }
+
+    // Dựng lại Work theo id mới (-1 = bỏ); order[i] là trạng thái cũ đại diện của id i
+    void remap(Work& w, const vector<int>& id, const vector<int>& order) {
+        Work out;
+        out.k = w.k;
+        int kept = order.size();
+        out.members.resize(kept);
+        out.is_start.assign(kept, 0); out.is_final.assign(kept, 0); out.accept_class.resize(kept);
+        for (int i = 0; i < kept; ++i) {
+            out.is_final[i] = w.is_final[order[i]];
+            out.accept_class[i] = w.accept_class[order[i]];
+        }
+        for (size_t u = 0; u < w.members.size(); ++u) {
+            if (id[u] == -1) continue;
+            out.is_start[id[u]] |= w.is_start[u];
+            out.members[id[u]].insert(out.members[id[u]].end(), w.members[u].begin(), w.members[u].end());
+        }
+        for (const LTSEdge& e : w.edges)
+            if (id[e.from] != -1 && id[e.to] != -1) out.edges.push_back({id[e.from], e.label, id[e.to]});
+        sort(out.edges.begin(), out.edges.end());
+        out.edges.erase(unique(out.edges.begin(), out.edges.end()), out.edges.end());
+        w = move(out);
+    }
+
+    // Một lượt mô phỏng tiến (backward = false) hoặc lùi (trên NFA đảo)
+    void step(Work& w, bool backward) {
+        int n = w.members.size();
+        vector<LTSEdge> E = w.edges;
+        if (backward) for (LTSEdge& e : E) swap(e.from, e.to);
+
+        // Nhãn khởi tạo: (is_start, is_end, accept_class); mô phỏng tiến bỏ qua is_start
+        map<tuple<bool, bool, string>, int> key_ids;
+        auto keyOf = [&](int u) { return make_tuple(backward && w.is_start[u], w.is_final[u] != 0, w.accept_class[u]); };
+        for (int u = 0; u < n; ++u) key_ids[keyOf(u)] = 0;
+        vector<tuple<bool, bool, string>> keys;
+        for (auto& p : key_ids) { p.second = (int)keys.size(); keys.push_back(p.first); }
+        vector<int> label(n);
+        for (int u = 0; u < n; ++u) label[u] = key_ids[keyOf(u)];
+        auto compatible = [&](int l1, int l2) {
+            const auto& a = keys[l1];
+            const auto& b = keys[l2];
+            if (backward) return get<1>(a) == get<1>(b) && get<2>(a) == get<2>(b) && (!get<0>(a) || get<0>(b));
+            return !get<1>(a) || (get<1>(b) && get<2>(a) == get<2>(b));
+        };
+        SimulationPreorder sim;
+        sim.compute(n, E, w.k, label, (int)keys.size(), compatible, control);
+        splitter_rounds += sim.splitter_rounds;
+
+        // Gộp các khối tương đương mô phỏng (rel hai chiều); lớp đánh số theo trạng thái nhỏ nhất
+        int blocks = sim.part.blockCount();
+        vector<int> cls_block(blocks, -1), id(n), order;
+        vector<int> class_of(blocks, -1);
+        for (int u = 0; u < n; ++u) {
+            int b = sim.part.block[u];
+            if (class_of[b] == -1) {
+                for (int c = 0; c < blocks; ++c)
+                    if (class_of[c] != -1 && sim.leqBlocks(b, c) && sim.leqBlocks(c, b)) { class_of[b] = class_of[c]; break; }
+                if (class_of[b] == -1) { class_of[b] = (int)order.size(); cls_block[order.size()] = b; order.push_back(u); }
             }
+            id[u] = class_of[b];
         }
-        return minDFA;
+
+        // Bỏ cạnh tới lớp bị mô phỏng chặt bởi một đích khác cùng nguồn, cùng nhãn
+        int classes = order.size();
+        vector<LTSEdge> Q;
+        for (const LTSEdge& e : E) Q.push_back({id[e.from], e.label, id[e.to]});
+        sort(Q.begin(), Q.end());
+        Q.erase(unique(Q.begin(), Q.end()), Q.end());
+        vector<LTSEdge> kept;
+        for (size_t i = 0; i < Q.size();) {
+            size_t j = i;
+            while (j < Q.size() && Q[j].from == Q[i].from && Q[j].label == Q[i].label) ++j;
+            for (size_t x = i; x < j; ++x) {
+                bool dominated = false;
+                for (size_t y = i; y < j && !dominated; ++y)
+                    dominated = y != x && sim.leqBlocks(cls_block[Q[x].to], cls_block[Q[y].to]);
+                if (dominated) pruned_transitions++;
+                else kept.push_back(Q[x]);
+            }
+            i = j;
+        }
+        if (backward) for (LTSEdge& e : kept) swap(e.from, e.to);
+
+        // Trạng thái bắt đầu bị mô phỏng tiến chặt bởi trạng thái bắt đầu khác là thừa
+        vector<char> drop_start(classes, 0);
+        if (!backward) {
+            vector<int> starts;
+            for (int u = 0; u < n; ++u) if (w.is_start[u]) starts.push_back(id[u]);
+            sort(starts.begin(), starts.end());
+            starts.erase(unique(starts.begin(), starts.end()), starts.end());
+            for (int s : starts)
+                for (int t : starts)
+                    if (s != t && sim.leqBlocks(cls_block[s], cls_block[t])) { drop_start[s] = 1; break; }
+        }
+
+        w.edges.clear();
+        remap(w, id, order);
+        w.edges = kept;
+        sort(w.edges.begin(), w.edges.end());
+        for (int c = 0; c < classes; ++c) if (drop_start[c]) w.is_start[c] = 0;
     }
 };
 
-// === PHẦN 3: HÀM MAIN ===
+// Tất định hóa (dựng tập con) LTS thành DFA để chạy Hopcroft; trạng thái "q0", "q1", ...
+// theo thứ tự phát hiện. Trạng thái không tới được trạng thái kết thúc bị bỏ khỏi tập con
+// nên DFA không có trạng thái chết. Tập con kết thúc nếu chứa trạng thái kết thúc; các
+// trạng thái kết thúc trong một tập con phải cùng accept_class.
+DFA determinizeLTS(const LTS& lts, SolverControl& control, size_t memory_budget_bytes, int& subset_states) {
+    for (const auto& l : lts.labels)
+        if (!l.second.empty()) throw runtime_error("Tat dinh hoa khong ho tro output tren canh");
+    int n = lts.names.size();
+    vector<int> out_offset(n + 1, 0);
+    for (const LTSEdge& e : lts.edges) out_offset[e.from + 1]++;
+    for (int u = 0; u < n; ++u) out_offset[u + 1] += out_offset[u];
+    vector<vector<int>> pred(n);
+    for (const LTSEdge& e : lts.edges) pred[e.to].push_back(e.from);
+    vector<char> live(n, 0);
+    vector<int> stack;
+    for (int u = 0; u < n; ++u) if (lts.is_final[u]) { live[u] = 1; stack.push_back(u); }
+    while (!stack.empty()) {
+        int u = stack.back(); stack.pop_back();
+        for (int v : pred[u]) if (!live[v]) { live[v] = 1; stack.push_back(v); }
+    }
 
-// Hàm lấy memory usage (Windows)
-size_t getCurrentMemoryUsage() {
-    PROCESS_MEMORY_COUNTERS_EX pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
-        return pmc.WorkingSetSize / 1024; // Convert to KB
+    DFA dfa;
+    map<vector<int>, int> ids;
+    vector<vector<int>> subsets;
+    vector<int> start;
+    bool has_start = false;
+    for (int u = 0; u < n; ++u) {
+        has_start = has_start || lts.is_start[u];
+        if (lts.is_start[u] && live[u]) start.push_back(u);
+    }
+    if (!has_start) throw runtime_error("NFA khong co trang thai bat dau");
+    ids[start] = 0; subsets.push_back(start);
+    size_t subset_bytes = start.size() * sizeof(int);
+    dfa.setStart("q0");
+
+    SolverProgress progress;
+    vector<pair<int, int>> moves; // (nhãn, đích)
+    for (size_t i = 0; i < subsets.size(); ++i) {
+        progress.blocks = subsets.size();
+        progress.worklist = subsets.size() - i;
+        control.poll(progress);
+        string name = "q" + to_string(i);
+        string cls;
+        bool is_final = false;
+        moves.clear();
+        for (int u : subsets[i]) {
+            if (lts.is_final[u]) {
+                if (is_final && lts.accept_class[u] != cls)
+                    throw runtime_error("Xung dot accept_class khi tat dinh hoa: " + cls + " / " + lts.accept_class[u]);
+                is_final = true;
+                cls = lts.accept_class[u];
+            }
+            for (int p = out_offset[u]; p < out_offset[u + 1]; ++p)
+                if (live[lts.edges[p].to]) moves.push_back({lts.edges[p].label, lts.edges[p].to});
+        }
+        if (is_final) dfa.addFinal(name);
+        if (is_final && !cls.empty()) dfa.setAcceptClass(name, cls);
+        sort(moves.begin(), moves.end());
+        moves.erase(unique(moves.begin(), moves.end()), moves.end());
+        for (size_t a = 0; a < moves.size();) {
+            size_t b = a;
+            vector<int> target;
+            for (; b < moves.size() && moves[b].first == moves[a].first; ++b) target.push_back(moves[b].second);
+            auto it = ids.find(target);
+            int t;
+            if (it != ids.end()) t = it->second;
+            else {
+                // Mỗi tập con lưu hai lần (khóa map và danh sách)
+                subset_bytes += 2 * (target.size() * sizeof(int) + 64);
+                if (subset_bytes > memory_budget_bytes)
+                    throw runtime_error("Tat dinh hoa vuot ngan sach bo nho (" + to_string(subsets.size()) + " tap con)");
+                t = (int)subsets.size(); ids[target] = t; subsets.push_back(target);
+            }
+            dfa.addTransition(name, lts.labels[moves[a].first].first, "q" + to_string(t));
+            a = b;
+        }
     }
+    subset_states = subsets.size();
+    return dfa;
+}
+
+// === PHẦN 3: HÀM MAIN ===
+// Chế độ tăng dần: input là DFA trước khi sửa, previous là kết quả cũ của solver
+// (không có thì tối thiểu hóa từ đầu trong bộ nhớ), delta là các thay đổi.
+int runIncremental(const string& inputFile, const string& outputFile, const string& deltaFile,
+                   const string& previousFile, const string& editedFile,
+                   const string& truthFile, bool printHash, const SolverControl& control) {
+    getCPUUsage();
+    DFA myDFA = loadDFA_JSON(inputFile);
+    DFADelta delta = loadDelta_JSON(deltaFile);
+    string testCaseLabel = extractTestCaseLabel(inputFile);
+
+    auto loadStart = chrono::high_resolution_clock::now();
+    IncrementalMinimizer minimizer = previousFile.empty()
+        ? IncrementalMinimizer(myDFA, control)
+        : IncrementalMinimizer(myDFA, loadDFA_JSON(previousFile), control);
+    auto start = chrono::high_resolution_clock::now();
+    minimizer.apply(delta);
+    const DFA& result = minimizer.result();
+    auto end = chrono::high_resolution_clock::now();
+
+    double prepareMs = chrono::duration_cast<chrono::microseconds>(start - loadStart).count() / 1000.0;
+    double wallTimeMs = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+    int finalStates = result.states.size();
+    DFA minDFA = canonicalizeDFA(result);
+    exportDFA_JSON(minDFA, outputFile);
+    if (!editedFile.empty()) exportDFA_JSON(minimizer.current(), editedFile);
+
+    cout << "Test_Case_Label: " << testCaseLabel << endl;
+    cout << "Initial_States: " << myDFA.states.size() << endl;
+    cout << "Final_States: " << finalStates << endl;
+    cout << "Delta_Edits: " << delta.size() << endl;
+    cout << "Incremental_Mode: " << (minimizer.last_fallback ? "fallback" : "local") << endl;
+    if (!minimizer.last_fallback) cout << "Merge_Region_Blocks: " << minimizer.last_region << endl;
+    cout << "Prepare_Time_ms: " << fixed << setprecision(3) << prepareMs << endl;
+    cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
+    cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << getCPUUsage() << endl;
+    cout << "Memory_Usage_KB: " << getCurrentMemoryUsage() << endl;
+    cout << "Peak_Memory_KB: " << getPeakMemoryUsage() << endl;
+    if (!truthFile.empty())
+        cout << "Ground_Truth_Check: " << checkGroundTruth(minDFA, truthFile) << endl;
+    if (printHash)
+        cout << "Canonical_Hash: " << canonicalHash(minDFA) << endl;
     return 0;
 }
 
-size_t getPeakMemoryUsage() {
-    PROCESS_MEMORY_COUNTERS_EX pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
-        return pmc.PeakWorkingSetSize / 1024; // Convert to KB
-    }
+// Chế độ out-of-core: input và output ở định dạng nhị phân DFAB
+int runExternal(const string& inputFile, const string& outputFile, double memBudgetMB,
+                const string& tempDir, const SolverControl& control) {
+    // DFAB chỉ lưu bảng chuyển và một bit chấp nhận: không nhận JSON (có thể mang
+    // accept_class / output) để tránh bỏ ngầm các trường đó
+    if (!isBinaryDFA(inputFile))
+        throw runtime_error("--external chi nhan file DFAB (khong luu accept_class / output): " + inputFile);
+    getCPUUsage();
+    string testCaseLabel = extractTestCaseLabel(inputFile);
+    ExternalHopcroft solver;
+    solver.control = control;
+    solver.memory_budget_bytes = (size_t)(memBudgetMB * 1024 * 1024);
+    solver.temp_dir = tempDir;
+    bool workingSetLimited = limitWorkingSet(solver.memory_budget_bytes);
+
+    size_t faultsBefore = getPageFaultCount();
+    auto start = chrono::high_resolution_clock::now();
+    solver.minimize(inputFile, outputFile);
+    auto end = chrono::high_resolution_clock::now();
+    size_t pageFaults = getPageFaultCount() - faultsBefore;
+    double wallTimeMs = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+    cout << "Test_Case_Label: " << testCaseLabel << endl;
+    cout << "Initial_States: " << solver.num_states << endl;
+    cout << "Final_States: " << solver.result_states << endl;
+    cout << "Alphabet_Size: " << solver.alphabet_size << endl;
+    cout << "Transitions: " << solver.num_transitions << endl;
+    cout << "Memory_Budget_MB: " << fixed << setprecision(0) << memBudgetMB << endl;
+    cout << "Working_Set_Limited: " << (workingSetLimited ? 1 : 0) << endl;
+    cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
+    cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << getCPUUsage() << endl;
+    cout << "Memory_Usage_KB: " << getCurrentMemoryUsage() << endl;
+    cout << "Peak_Memory_KB: " << getPeakMemoryUsage() << endl;
+    cout << "Page_Faults: " << pageFaults << endl;
     return 0;
 }
 
-// Hàm lấy CPU usage (Windows)
-double getCPUUsage() {
-    static ULARGE_INTEGER lastCPU, lastSysCPU, lastUserCPU;
-    static int numProcessors;
-    static HANDLE self;
-    static bool initialized = false;
-
-    if (!initialized) {
-        SYSTEM_INFO sysInfo;
-        FILETIME ftime, fsys, fuser;
-        GetSystemInfo(&sysInfo);
-        numProcessors = sysInfo.dwNumberOfProcessors;
-        GetSystemTimeAsFileTime(&ftime);
-        memcpy(&lastCPU, &ftime, sizeof(FILETIME));
-        self = GetCurrentProcess();
-        GetProcessTimes(self, &ftime, &ftime, &fsys, &fuser);
-        memcpy(&lastSysCPU, &fsys, sizeof(FILETIME));
-        memcpy(&lastUserCPU, &fuser, sizeof(FILETIME));
-        initialized = true;
-        return 0.0;
-    }
-
-    FILETIME ftime, fsys, fuser;
-    ULARGE_INTEGER now, sys, user;
-    double percent;
-
-    GetSystemTimeAsFileTime(&ftime);
-    memcpy(&now, &ftime, sizeof(FILETIME));
-    GetProcessTimes(self, &ftime, &ftime, &fsys, &fuser);
-    memcpy(&sys, &fsys, sizeof(FILETIME));
-    memcpy(&user, &fuser, sizeof(FILETIME));
-    
-    percent = (sys.QuadPart - lastSysCPU.QuadPart) + (user.QuadPart - lastUserCPU.QuadPart);
-    percent /= (now.QuadPart - lastCPU.QuadPart);
-    percent /= numProcessors;
-    
-    lastCPU = now;
-    lastUserCPU = user;
-    lastSysCPU = sys;
-
-    return percent * 100.0;
+// Chế độ bảng chữ cái ký hiệu: input là khoảng code point, output ghi lại theo cùng cú pháp
+int runSymbolic(const string& inputFile, const string& outputFile, const string& truthFile,
+                bool printHash, const SolverControl& control) {
+    getCPUUsage();
+    SymbolicDFA myDFA = loadSymbolicDFA_JSON(inputFile);
+    string testCaseLabel = extractTestCaseLabel(inputFile);
+
+    auto start = chrono::high_resolution_clock::now();
+    SymbolicHopcroft solver;
+    solver.control = control;
+    SymbolicDFA minSym = solver.minimize(myDFA);
+    auto end = chrono::high_resolution_clock::now();
+    double wallTimeMs = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+    DFA minDFA = canonicalizeDFA(toIntervalDFA(minSym));
+    exportDFA_JSON(minDFA, outputFile);
+
+    cout << "Test_Case_Label: " << testCaseLabel << endl;
+    cout << "Initial_States: " << myDFA.names.size() << endl;
+    cout << "Final_States: " << minSym.names.size() << endl;
+    cout << "Input_Intervals: " << myDFA.intervalCount() << endl;
+    cout << "Output_Intervals: " << minSym.intervalCount() << endl;
+    cout << "Splitter_Minterms: " << solver.splitter_minterms << endl;
+    cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
+    cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << getCPUUsage() << endl;
+    cout << "Memory_Usage_KB: " << getCurrentMemoryUsage() << endl;
+    cout << "Peak_Memory_KB: " << getPeakMemoryUsage() << endl;
+    if (!truthFile.empty())
+        cout << "Ground_Truth_Check: " << checkGroundTruth(minDFA, truthFile) << endl;
+    if (printHash)
+        cout << "Canonical_Hash: " << canonicalHash(minDFA) << endl;
+    return 0;
 }
 
-// Hàm trích xuất test case label từ filename
-string extractTestCaseLabel(const string& filename) {
-    // Extract from filename like "1000_states_dfa.json" -> "1000"
-    size_t pos = filename.find_last_of("/\\");
-    string basename = (pos == string::npos) ? filename : filename.substr(pos + 1);
-    
-    // Try to extract number at the beginning
-    size_t underscore = basename.find('_');
-    if (underscore != string::npos) {
-        return basename.substr(0, underscore);
-    }
-    
-    // If no underscore, return basename without extension
-    size_t dot = basename.find_last_of('.');
-    return (dot == string::npos) ? basename : basename.substr(0, dot);
+// Chế độ NFA / LTS: thương theo bisimulation (mặc định) hoặc rút gọn theo mô phỏng
+// (--simulation); --determinize dựng tập con rồi tối thiểu hóa bằng Hopcroft
+int runNFA(const string& inputFile, const string& outputFile, bool printHash,
+           bool simulation, bool determinize, double memBudgetMB, const SolverControl& control) {
+    getCPUUsage();
+    LTS myLTS = loadLTS_JSON(inputFile);
+    string testCaseLabel = extractTestCaseLabel(inputFile);
+
+    auto start = chrono::high_resolution_clock::now();
+    LTS reduced;
+    long long splitters = 0;
+    SimulationReducer reducer;
+    if (simulation) {
+        reducer.control = control;
+        reduced = reducer.reduce(myLTS);
+        splitters = reducer.splitter_rounds;
+    } else if (determinize) {
+        reduced = myLTS;
+    } else {
+        PaigeTarjan solver;
+        solver.control = control;
+        reduced = solver.minimize(myLTS);
+        splitters = solver.splitter_blocks;
+    }
+    DFA minDFA;
+    int subsetStates = 0;
+    if (determinize) {
+        SolverControl subsetControl = control;
+        DFA subsetDFA = determinizeLTS(reduced, subsetControl, (size_t)(memBudgetMB * 1024 * 1024), subsetStates);
+        AlphabetClasses alphabetClasses;
+        DFA reducedDFA = compressAlphabet(subsetDFA, alphabetClasses);
+        RowMerge rowMerge;
+        DFA dedupDFA = mergeDuplicateRows(reducedDFA, rowMerge);
+        HopcroftSolver solver;
+        solver.control = control;
+        minDFA = solver.minimize(dedupDFA);
+        minDFA = restoreMergedStates(minDFA, dedupDFA, reducedDFA, rowMerge);
+        minDFA = canonicalizeDFA(expandAlphabet(minDFA, alphabetClasses));
+    }
+    auto end = chrono::high_resolution_clock::now();
+    double wallTimeMs = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+    if (determinize) exportDFA_JSON(minDFA, outputFile);
+    else exportLTS_JSON(reduced, outputFile);
+
+    cout << "Test_Case_Label: " << testCaseLabel << endl;
+    cout << "Initial_States: " << myLTS.names.size() << endl;
+    cout << "Final_States: " << (determinize ? minDFA.states.size() : reduced.names.size()) << endl;
+    cout << "Input_Transitions: " << myLTS.edges.size() << endl;
+    cout << "Labels: " << myLTS.labels.size() << endl;
+    if (simulation || !determinize) {
+        if (determinize) cout << "Reduced_States: " << reduced.names.size() << endl;
+        cout << (determinize ? "Reduced_Transitions: " : "Output_Transitions: ") << reduced.edges.size() << endl;
+        cout << "Splitter_Blocks: " << splitters << endl;
+    }
+    if (simulation) {
+        cout << "Simulation_Passes: " << reducer.passes << endl;
+        cout << "Pruned_Transitions: " << reducer.pruned_transitions << endl;
+    }
+    if (determinize) cout << "Subset_States: " << subsetStates << endl;
+    cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
+    cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << getCPUUsage() << endl;
+    cout << "Memory_Usage_KB: " << getCurrentMemoryUsage() << endl;
+    cout << "Peak_Memory_KB: " << getPeakMemoryUsage() << endl;
+    if (determinize && printHash)
+        cout << "Canonical_Hash: " << canonicalHash(minDFA) << endl;
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
     string inputFile = (argc > 1) ? argv[1] : "50000_states_dfa.json";
     string outputFile = (argc > 2) ? argv[2] : "output.json";
+    string truthFile;
+    bool printHash = false;
+    double deadlineMs = 0; // 0 = không giới hạn
+    bool printProgress = false;
+    int threads = 1; // 0 = số lõi của máy
+    string partition = "flat"; // flat | sets
+    string deltaFile, previousFile, editedFile;
+    bool external = false; // Tự bật khi input là file nhị phân DFAB
+    double memBudgetMB = 1024;
+    string tempDir;
+    bool symbolic = false; // Input là khoảng code point
+    bool nfa = false; // Input là NFA / LTS (nhiều đích cho cùng input)
+    bool simulation = false, determinize = false; // Chỉ dùng với --nfa
+    for (int i = 3; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--truth" && i + 1 < argc) truthFile = argv[++i];
+        else if (arg == "--hash") printHash = true;
+        else if (arg == "--deadline-ms" && i + 1 < argc) deadlineMs = stod(argv[++i]);
+        else if (arg == "--progress") printProgress = true;
+        else if (arg == "--threads" && i + 1 < argc) threads = stoi(argv[++i]);
+        else if (arg == "--partition" && i + 1 < argc) partition = argv[++i];
+        else if (arg == "--delta" && i + 1 < argc) deltaFile = argv[++i];
+        else if (arg == "--previous" && i + 1 < argc) previousFile = argv[++i];
+        else if (arg == "--edited-out" && i + 1 < argc) editedFile = argv[++i];
+        else if (arg == "--external") external = true;
+        else if (arg == "--mem-budget-mb" && i + 1 < argc) memBudgetMB = stod(argv[++i]);
+        else if (arg == "--temp-dir" && i + 1 < argc) tempDir = argv[++i];
+        else if (arg == "--symbolic") symbolic = true;
+        else if (arg == "--nfa") nfa = true;
+        else if (arg == "--simulation") simulation = true;
+        else if (arg == "--determinize") determinize = true;
+    }
 
     try {
+        if (!deltaFile.empty() || nfa || symbolic || external || isBinaryDFA(inputFile)) {
+            SolverControl control;
+            if (deadlineMs > 0)
+                control.deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(deadlineMs * 1000));
+            if (printProgress) {
+                control.on_progress = [](const SolverProgress& p) {
+                    cerr << "Progress: rounds=" << p.rounds << " blocks=" << p.blocks
+                         << " marked_pairs=" << p.marked_pairs << " worklist=" << p.worklist << endl;
+                };
+            }
+            if (!deltaFile.empty())
+                return runIncremental(inputFile, outputFile, deltaFile, previousFile, editedFile, truthFile, printHash, control);
+            if (nfa) return runNFA(inputFile, outputFile, printHash, simulation, determinize, memBudgetMB, control);
+            if (symbolic) return runSymbolic(inputFile, outputFile, truthFile, printHash, control);
+            return runExternal(inputFile, outputFile, memBudgetMB, tempDir, control);
+        }
+
         // Initialize CPU monitoring
         getCPUUsage();
         
@@ -301,9 +2106,25 @@ int main(int argc, char* argv[]) {
         auto start = chrono::high_resolution_clock::now();
         size_t memBefore = getCurrentMemoryUsage();
         
-        // Run minimization
-        Solver solver;
-        DFA minDFA = solver.minimize(myDFA);
+        // Run minimization (trên bảng chữ cái đã nén, sau khi gộp các hàng trùng nhau)
+        AlphabetClasses alphabetClasses;
+        DFA reducedDFA = compressAlphabet(myDFA, alphabetClasses);
+        RowMerge rowMerge;
+        DFA dedupDFA = mergeDuplicateRows(reducedDFA, rowMerge);
+        HopcroftSolver solver;
+        solver.threads = (threads > 0) ? threads : max(1, (int)thread::hardware_concurrency());
+        solver.partition = partition;
+        if (deadlineMs > 0)
+            solver.control.deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(deadlineMs * 1000));
+        if (printProgress) {
+            solver.control.on_progress = [](const SolverProgress& p) {
+                cerr << "Progress: rounds=" << p.rounds << " blocks=" << p.blocks
+                     << " marked_pairs=" << p.marked_pairs << " worklist=" << p.worklist << endl;
+            };
+        }
+        DFA minDFA = solver.minimize(dedupDFA);
+        minDFA = restoreMergedStates(minDFA, dedupDFA, reducedDFA, rowMerge);
+        minDFA = expandAlphabet(minDFA, alphabetClasses);
         
         // End timing and memory measurement
         auto end = chrono::high_resolution_clock::now();
@@ -315,6 +2136,9 @@ int main(int argc, char* argv[]) {
         auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
         double wallTimeMs = duration.count() / 1000.0;
         int finalStates = minDFA.states.size();
+
+        // Đánh số lại theo BFS để kết quả không phụ thuộc thứ tự duyệt của solver
+        minDFA = canonicalizeDFA(minDFA);
         size_t memoryUsage = memAfter;
         
         // Export result
@@ -324,14 +2148,27 @@ int main(int argc, char* argv[]) {
         cout << "Test_Case_Label: " << testCaseLabel << endl;
         cout << "Initial_States: " << initialStates << endl;
         cout << "Final_States: " << finalStates << endl;
+        cout << "Alphabet_Size: " << alphabetClasses.original_size << endl;
+        cout << "Alphabet_Classes: " << reducedDFA.alphabet.size() << endl;
+        cout << "Dedup_States: " << dedupDFA.states.size() << endl;
+        cout << "Dedup_Passes: " << rowMerge.passes << endl;
+        cout << "Threads: " << solver.threads << endl;
+        cout << "Partition: " << solver.partition << endl;
         cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
         cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << cpuUsage << endl;
         cout << "Memory_Usage_KB: " << memoryUsage << endl;
         cout << "Peak_Memory_KB: " << peakMem << endl;
+        if (!truthFile.empty())
+            cout << "Ground_Truth_Check: " << checkGroundTruth(minDFA, truthFile) << endl;
+        if (printHash)
+            cout << "Canonical_Hash: " << canonicalHash(minDFA) << endl;
         
+    } catch (const SolverCancelled& e) {
+        cerr << "CANCELLED: " << e.what() << endl;
+        return 3;
     } catch (const exception& e) {
         cerr << "ERROR: " << e.what() << endl;
         return 1;
     }
     return 0;
-}
\ No newline at end of file
+}
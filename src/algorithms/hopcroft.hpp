@@ -0,0 +1,510 @@
+// Hopcroft trong bộ nhớ: phân hoạch phẳng RefinablePartition và lớp HopcroftSolver.
+// Dùng chung giữa hopcroft.cpp (main riêng) và portfolio.cpp.
+#ifndef HOPCROFT_HPP
+#define HOPCROFT_HPP
+
+#include <thread>
+#include <unordered_map>
+#include "dfa_core.hpp"
+
+// === PHẦN 2: LOGIC HOPCROFT ===
+// Phân hoạch phẳng tinh chỉnh được (kiểu Paige-Tarjan): khối b chiếm
+// elements[first[b] .. last[b]), pos[u] là vị trí của u, block[u] là khối chứa u.
+// W là hàng đợi splitter của Hopcroft (in_w tránh trùng lặp).
+struct RefinablePartition {
+    vector<int> elements, pos, block, first, last, marked;
+    vector<char> in_w;
+    vector<int> W;
+    // Nhật ký tách cho IncrementalMinimizer: (khối cũ, khối mới), khối cũ = -1 khi thêm
+    // trạng thái mới. Chỉ ghi khi log_splits bật.
+    bool log_splits = false;
+    vector<pair<int, int>> split_log;
+    vector<int> free_blocks; // Id của khối đã bị gộp (rỗng), newBlock dùng lại
+
+    int blockCount() const { return (int)first.size(); }
+    int blockSize(int b) const { return last[b] - first[b]; }
+
+    // Trạng thái có cùng nhãn vào cùng khối; nhãn trong [0, num_labels), -1 = bỏ qua.
+    // Mọi nhãn phải có ít nhất một trạng thái.
+    void init(const vector<int>& label, int num_labels) {
+        int n = (int)label.size();
+        vector<int> start(num_labels + 1, 0);
+        for (int l : label) if (l >= 0) start[l + 1]++;
+        for (int b = 0; b < num_labels; ++b) start[b + 1] += start[b];
+        elements.assign(start[num_labels], 0);
+        pos.assign(n, -1); block.assign(n, -1);
+        first.assign(start.begin(), start.end() - 1);
+        last = first;
+        for (int u = 0; u < n; ++u) {
+            if (label[u] < 0) continue;
+            pos[u] = last[label[u]]; elements[last[label[u]]++] = u; block[u] = label[u];
+        }
+        marked.assign(num_labels, 0);
+        in_w.assign(num_labels, 0);
+        W.clear();
+        split_log.clear();
+        free_blocks.clear();
+        holes = 0;
+    }
+
+    void push(int b) { if (!in_w[b]) { in_w[b] = 1; W.push_back(b); } }
+    int pop() { int b = W.back(); W.pop_back(); in_w[b] = 0; return b; }
+
+    // Thêm trạng thái mới u (u >= số trạng thái hiện có) thành khối đơn
+    int addElement(int u) {
+        if (u >= (int)pos.size()) { pos.resize(u + 1, -1); block.resize(u + 1, -1); }
+        pos[u] = (int)elements.size(); elements.push_back(u);
+        return newBlock(pos[u], pos[u] + 1, -1);
+    }
+
+    // Tách u khỏi khối của nó thành khối đơn; trả về khối chứa u
+    int isolate(int u) {
+        int b = block[u];
+        if (blockSize(b) == 1) return b;
+        int target = last[b] - 1, w = elements[target];
+        swap(elements[target], elements[pos[u]]);
+        pos[w] = pos[u]; pos[u] = target;
+        last[b]--;
+        int nb = newBlock(target, target + 1, b);
+        push(nb); // Khối đơn luôn là nửa nhỏ hơn
+        return nb;
+    }
+
+    // Tách mọi khối theo tập X (không trùng lặp): phần thuộc X thành khối mới.
+    // Luật Hopcroft: khối đang trong W thì thêm cả hai nửa, ngược lại thêm nửa nhỏ hơn.
+    void splitBy(const vector<int>& X) {
+        touched.clear();
+        for (int u : X) {
+            int b = block[u];
+            if (marked[b] == 0) touched.push_back(b);
+            int target = first[b] + marked[b]++;
+            int w = elements[target];
+            swap(elements[target], elements[pos[u]]);
+            pos[w] = pos[u]; pos[u] = target;
+        }
+        for (int b : touched) {
+            int split = first[b] + marked[b];
+            marked[b] = 0;
+            if (split == last[b]) continue;
+            int nb = newBlock(first[b], split, b);
+            first[b] = split;
+            if (in_w[b]) push(nb);
+            else push(blockSize(nb) <= blockSize(b) ? nb : b);
+        }
+    }
+
+    // Hopcroft tuần tự cho tới khi W rỗng. forEachPred(v, c, f) gọi f(u) cho mọi u
+    // có cạnh u --c--> v.
+    template <class ForEachPred>
+    void refine(int k, ForEachPred forEachPred, SolverControl& control, SolverProgress& progress) {
+        vector<int> members, X;
+        while (!W.empty()) {
+            progress.blocks = blockCount();
+            progress.worklist = W.size();
+            control.poll(progress);
+            progress.rounds++;
+            int b = pop();
+            members.assign(elements.begin() + first[b], elements.begin() + last[b]);
+            for (int c = 0; c < k; ++c) {
+                X.clear();
+                for (int v : members) forEachPred(v, c, [&](int u) { X.push_back(u); });
+                if (!X.empty()) splitBy(X);
+            }
+        }
+    }
+
+    // Gộp các khối others vào khối a (IncrementalMinimizer, gọi khi W rỗng): thành viên
+    // được chép ra cuối elements, ô cũ bỏ trống; khối bị gộp thành rỗng. Chỗ trống vượt
+    // nửa elements thì nén lại, nên chi phí trung bình tỉ lệ với kích thước khối được gộp.
+    void mergeInto(int a, const vector<int>& others) {
+        int start = (int)elements.size();
+        auto relocate = [&](int b) {
+            for (int i = first[b]; i < last[b]; ++i) {
+                int u = elements[i];
+                pos[u] = (int)elements.size(); block[u] = a;
+                elements.push_back(u);
+            }
+            holes += blockSize(b);
+        };
+        relocate(a);
+        for (int b : others) {
+            relocate(b);
+            first[b] = last[b] = 0;
+            free_blocks.push_back(b);
+        }
+        first[a] = start; last[a] = (int)elements.size();
+        if (holes * 2 > (int)elements.size()) compact();
+    }
+
+    set<set<int>> toSets() const {
+        set<set<int>> P;
+        for (int b = 0; b < blockCount(); ++b)
+            P.insert(set<int>(elements.begin() + first[b], elements.begin() + last[b]));
+        return P;
+    }
+
+private:
+    vector<int> touched;
+    int holes = 0;
+
+    int newBlock(int begin, int end, int parent) {
+        int nb;
+        if (!free_blocks.empty()) {
+            nb = free_blocks.back(); free_blocks.pop_back();
+            first[nb] = begin; last[nb] = end;
+        } else {
+            nb = (int)first.size();
+            first.push_back(begin); last.push_back(end);
+            marked.push_back(0); in_w.push_back(0);
+        }
+        for (int i = begin; i < end; ++i) block[elements[i]] = nb;
+        if (log_splits) split_log.push_back({parent, nb});
+        return nb;
+    }
+
+    void compact() {
+        vector<int> packed;
+        packed.reserve(elements.size() - holes);
+        for (int b = 0; b < blockCount(); ++b) {
+            int begin = (int)packed.size();
+            for (int i = first[b]; i < last[b]; ++i) {
+                pos[elements[i]] = (int)packed.size();
+                packed.push_back(elements[i]);
+            }
+            first[b] = begin; last[b] = (int)packed.size();
+        }
+        elements.swap(packed);
+        holes = 0;
+    }
+};
+
+class HopcroftSolver {
+private:
+    DFA removeUnreachable(const DFA& dfa) {
+        DFA clean = dfa; 
+        set<int> reachable; queue<int> q;
+        if (dfa.start_state == -1) return clean; 
+        q.push(dfa.start_state); reachable.insert(dfa.start_state);
+        while(!q.empty()) {
+            int u = q.front(); q.pop();
+            if (dfa.transitions.count(u)) {
+                for (auto const& p : dfa.transitions.at(u)) {
+                    if (!reachable.count(p.second)) {
+                        reachable.insert(p.second); q.push(p.second);
+                    }
+                }
+            }
+        }
+        clean.states = reachable;
+        set<int> new_finals;
+        for(int s : reachable) if(dfa.final_states.count(s)) new_finals.insert(s);
+        clean.final_states = new_finals;
+        return clean;
+    }
+
+    // Kiểm tra DFA không có chu trình bằng sắp xếp topo (Kahn) trên các hàng chuyển,
+    // O(n + m). Nếu có, order chứa các trạng thái theo thứ tự topo.
+    bool topologicalOrder(const DFA& dfa, vector<int>& order) {
+        vector<int> indeg(dfa.state_counter, 0);
+        for (int u : dfa.states) {
+            auto row = dfa.transitions.find(u);
+            if (row == dfa.transitions.end()) continue;
+            for (auto const& t : row->second) indeg[t.second]++;
+        }
+        order.clear();
+        for (int u : dfa.states) if (indeg[u] == 0) order.push_back(u);
+        for (size_t i = 0; i < order.size(); ++i) {
+            auto row = dfa.transitions.find(order[i]);
+            if (row == dfa.transitions.end()) continue;
+            for (auto const& t : row->second)
+                if (--indeg[t.second] == 0) order.push_back(t.second);
+        }
+        return order.size() == dfa.states.size();
+    }
+
+    struct SignatureHash {
+        size_t operator()(const vector<int>& v) const {
+            size_t h = v.size();
+            for (int x : v) h ^= (size_t)x + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    // Revuz: DFA không chu trình, O(n + m). Chia trạng thái theo chiều cao
+    // (đường đi dài nhất tới trạng thái không có cạnh ra); trạng thái tương đương
+    // có cùng chiều cao, nên chỉ cần so chữ ký (final, (c, lớp đích)...) trong
+    // từng nhóm chiều cao, duyệt từ thấp lên cao. Chỉ duyệt các cạnh có thật (không
+    // dựng bảng n * k) và dựng DFA thương thẳng từ cls.
+    DFA minimizeAcyclic(const DFA& dfa, const vector<int>& order) {
+        vector<int> height(dfa.state_counter, 0);
+        int max_height = 0;
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            int u = *it;
+            auto row = dfa.transitions.find(u);
+            if (row != dfa.transitions.end())
+                for (auto const& t : row->second) height[u] = max(height[u], height[t.second] + 1);
+            max_height = max(max_height, height[u]);
+        }
+        vector<vector<int>> buckets(max_height + 1);
+        for (int u : dfa.states) buckets[height[u]].push_back(u);
+
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        vector<int> cls(dfa.state_counter, -1);
+        vector<vector<int>> members;
+        unordered_map<vector<int>, int, SignatureHash> signature_to_id;
+        vector<int> signature;
+        SolverProgress progress;
+        for (const vector<int>& bucket : buckets) {
+            progress.blocks = members.size();
+            progress.worklist = buckets.size() - progress.rounds;
+            control.poll(progress);
+            progress.rounds++;
+            signature_to_id.clear();
+            for (int u : bucket) {
+                signature.clear();
+                signature.push_back(label[u]);
+                auto row = dfa.transitions.find(u);
+                if (row != dfa.transitions.end())
+                    for (auto const& t : row->second) { signature.push_back(t.first); signature.push_back(cls[t.second]); }
+                auto found = signature_to_id.find(signature);
+                if (found == signature_to_id.end()) {
+                    found = signature_to_id.emplace(signature, (int)members.size()).first;
+                    members.emplace_back();
+                }
+                cls[u] = found->second;
+                members[found->second].push_back(u);
+            }
+        }
+
+        return buildQuotient(dfa, cls, members);
+    }
+
+    // Hopcroft trên RefinablePartition (mặc định, kể cả một luồng). Mỗi vòng lấy toàn bộ W làm một lô
+    // splitter. Pha gom: các luồng nhận từng cặp (splitter, ký tự) qua bộ đếm nguyên tử,
+    // liệt kê tiền nhiệm vào bộ đệm riêng (chỉ đọc phân hoạch). Pha tách: một luồng áp
+    // dụng các bộ đệm theo thứ tự cố định, nên kết quả không phụ thuộc số luồng. Splitter
+    // dùng nội dung chụp lúc gom; khối bị tách trong cùng lô vẫn đúng vì splitter gốc
+    // đã (hoặc sẽ) được áp dụng đầy đủ. Chỉ pha gom chạy song song: tăng tốc bị chặn
+    // bởi tỉ lệ thời gian của pha tách (định luật Amdahl). num_threads = 1: pha gom chạy
+    // ngay trên luồng gọi, nên so sánh số luồng không lẫn với thay đổi thuật toán.
+    DFA minimizeFlat(const DFA& dfa, int num_threads) {
+        int n = dfa.state_counter, k = dfa.input_counter;
+
+        // Cạnh ngược dạng CSR: tiền nhiệm của v theo ký tự c nằm ở
+        // preds[offset[c * n + v] .. offset[c * n + v + 1])
+        vector<size_t> offset((size_t)n * k + 1, 0);
+        for (int u : dfa.states) {
+            auto row = dfa.transitions.find(u);
+            if (row == dfa.transitions.end()) continue;
+            for (auto const& p : row->second) offset[(size_t)p.first * n + p.second + 1]++;
+        }
+        for (size_t i = 1; i < offset.size(); ++i) offset[i] += offset[i - 1];
+        vector<int> preds(offset.back());
+        {
+            vector<size_t> fill(offset.begin(), offset.end() - 1);
+            for (int u : dfa.states) {
+                auto row = dfa.transitions.find(u);
+                if (row == dfa.transitions.end()) continue;
+                for (auto const& p : row->second) preds[fill[(size_t)p.first * n + p.second]++] = u;
+            }
+        }
+
+        // Khởi tạo theo nhãn đầu ra ({F, Q \ F} khi không có accept_class), mọi khối vào W
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        RefinablePartition part;
+        part.init(label, num_labels);
+        for (int b = 0; b < part.blockCount(); ++b) part.push(b);
+
+        SolverProgress progress;
+        vector<int> batch;
+        vector<vector<int>> buffers;
+        while (!part.W.empty()) {
+            progress.blocks = part.blockCount();
+            progress.worklist = part.W.size();
+            control.poll(progress);
+            progress.rounds++;
+            batch.clear();
+            while (!part.W.empty()) batch.push_back(part.pop());
+
+            // Pha gom (song song): bộ đệm của cặp (splitter i, ký tự c) là buffers[i * k + c]
+            size_t items = batch.size() * (size_t)k, work = 0;
+            buffers.assign(items, vector<int>());
+            for (int b : batch) work += part.blockSize(b);
+            auto gather = [&](atomic<size_t>& next) {
+                for (size_t item = next++; item < items; item = next++) {
+                    int b = batch[item / k], c = (int)(item % k);
+                    vector<int>& X = buffers[item];
+                    for (int i = part.first[b]; i < part.last[b]; ++i) {
+                        size_t key = (size_t)c * n + part.elements[i];
+                        X.insert(X.end(), preds.begin() + offset[key], preds.begin() + offset[key + 1]);
+                    }
+                }
+            };
+            atomic<size_t> next{0};
+            if (num_threads > 1 && work >= 4096) {
+                vector<thread> pool;
+                for (int t = 1; t < num_threads; ++t) pool.emplace_back(gather, ref(next));
+                gather(next);
+                for (thread& th : pool) th.join();
+            } else {
+                gather(next);
+            }
+
+            // Pha tách (tuần tự, thứ tự cố định)
+            for (vector<int>& X : buffers) {
+                part.splitBy(X);
+                vector<int>().swap(X);
+            }
+        }
+        vector<vector<int>> members(part.blockCount());
+        for (int b = 0; b < part.blockCount(); ++b)
+            members[b].assign(part.elements.begin() + part.first[b], part.elements.begin() + part.last[b]);
+        return buildQuotient(dfa, part.block, members);
+    }
+
+    // Tái tạo DFA thương trực tiếp từ lớp của mỗi trạng thái (cls[u] = b khi u thuộc
+    // members[b], mọi lớp khác rỗng), không qua set<set<int>> và các map theo tên:
+    // O(n log n + m). Tên trạng thái và nội dung giống buildFromPartition.
+    DFA buildQuotient(const DFA& dfa, const vector<int>& cls, const vector<vector<int>>& members) {
+        DFA minDFA;
+        minDFA.input_char_to_id = dfa.input_char_to_id;
+        minDFA.input_id_to_char = dfa.input_id_to_char;
+        minDFA.alphabet = dfa.alphabet;
+        minDFA.input_counter = dfa.input_counter;
+        int num_classes = members.size();
+        vector<string> nlist;
+        for (int b = 0; b < num_classes; ++b) {
+            nlist.clear();
+            for (int u : members[b]) nlist.push_back(dfa.state_id_to_name.at(u));
+            sort(nlist.begin(), nlist.end());
+            string name = "{";
+            for (size_t i = 0; i < nlist.size(); ++i) name += (i == 0 ? "" : ",") + nlist[i];
+            name += "}";
+            minDFA.getStateID(name); // ID mới = b
+        }
+        if (dfa.start_state != -1) minDFA.start_state = cls[dfa.start_state];
+        for (int b = 0; b < num_classes; ++b) {
+            int rep = members[b][0]; // Mọi trạng thái trong khối cùng nhãn đầu ra
+            if (dfa.final_states.count(rep)) minDFA.final_states.insert(b);
+            auto ac = dfa.accept_class.find(rep);
+            if (ac != dfa.accept_class.end()) minDFA.accept_class[b] = ac->second;
+            auto row = dfa.transitions.find(rep);
+            if (row != dfa.transitions.end())
+                for (auto const& t : row->second) minDFA.transitions[b][t.first] = cls[t.second];
+            auto out = dfa.transition_output.find(rep);
+            if (out != dfa.transition_output.end() && !out->second.empty())
+                minDFA.transition_output[b] = out->second;
+        }
+        return minDFA;
+    }
+
+public:
+    // Tái tạo DFA từ phân hoạch P (thứ tự trạng thái = thứ tự của set<set<int>>)
+    DFA buildFromPartition(DFA& dfa, const set<set<int>>& P) {
+        DFA minDFA;
+        minDFA.input_char_to_id = dfa.input_char_to_id;
+        minDFA.input_id_to_char = dfa.input_id_to_char;
+        minDFA.alphabet = dfa.alphabet;
+        map<int, string> mapping;
+        map<string, int> rep_map;
+        for(const set<int>& g : P) {
+            string name = "{"; 
+            int rep = *g.begin();
+            bool is_s = false, is_f = false;
+            auto cls = dfa.accept_class.end(); // Mọi trạng thái trong khối cùng nhãn
+            vector<string> nlist;
+            for(int s : g) {
+                nlist.push_back(dfa.state_id_to_name.at(s));
+                if(s == dfa.start_state) is_s = true;
+                if(dfa.final_states.count(s)) is_f = true;
+                if(dfa.accept_class.count(s)) cls = dfa.accept_class.find(s);
+            }
+            sort(nlist.begin(), nlist.end());
+            for(size_t i=0; i<nlist.size(); ++i) name += (i==0?"":",") + nlist[i];
+            name += "}";
+            minDFA.getStateID(name);
+            if(is_s) minDFA.setStart(name);
+            if(is_f) minDFA.addFinal(name);
+            if(cls != dfa.accept_class.end()) minDFA.setAcceptClass(name, cls->second);
+            rep_map[name] = rep;
+            for(int s : g) mapping[s] = name;
+        }
+        for(auto const& pair : rep_map) {
+            if(dfa.transitions.count(pair.second)) {
+                for(auto const& t : dfa.transitions.at(pair.second)) {
+                    minDFA.addTransition(pair.first, minDFA.input_id_to_char[t.first], mapping[t.second]);
+                }
+            }
+            if(dfa.transition_output.count(pair.second)) {
+                for(auto const& o : dfa.transition_output.at(pair.second))
+                    minDFA.setOutput(pair.first, minDFA.input_id_to_char[o.first], o.second);
+            }
+        }
+        return minDFA;
+    }
+
+    // Hủy / deadline / tiến độ, được kiểm tra ở ranh giới mỗi vòng tinh chỉnh
+    SolverControl control;
+    // Số luồng cho pha gom splitter của phân hoạch phẳng
+    int threads = 1;
+    // "flat" (RefinablePartition) hoặc "sets" (Hopcroft gốc trên set<set<int>>, giữ để đối chiếu)
+    string partition = "flat";
+
+    DFA minimize(DFA inputDFA) {
+        DFA dfa = removeUnreachable(inputDFA);
+        if (dfa.states.empty()) return dfa;
+
+        // DFA không chu trình (từ điển, tập từ khóa): dùng Revuz tuyến tính
+        vector<int> order;
+        if (topologicalOrder(dfa, order)) return minimizeAcyclic(dfa, order);
+        if (partition == "flat") return minimizeFlat(dfa, max(threads, 1));
+        if (partition != "sets") throw runtime_error("--partition khong hop le: " + partition);
+
+        // Khởi tạo: một khối cho mỗi nhãn đầu ra (Final / Non-Final, hoặc accept_class)
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        vector<set<int>> by_label(num_labels);
+        for(int s : dfa.states) by_label[label[s]].insert(s);
+        set<set<int>> P(by_label.begin(), by_label.end());
+        
+        set<set<int>> W = P;
+        map<int, map<int, set<int>>> inv;
+        for(int u : dfa.states)
+            for(auto const& p : dfa.transitions[u]) inv[p.second][p.first].insert(u);
+
+        SolverProgress progress;
+        while(!W.empty()) {
+            progress.blocks = P.size();
+            progress.worklist = W.size();
+            control.poll(progress);
+            progress.rounds++;
+            set<int> A = *W.begin(); W.erase(W.begin());
+            for(int c : dfa.alphabet) {
+                set<int> X;
+                for(int u : A) for(int pre : inv[u][c]) X.insert(pre);
+                if(X.empty()) continue;
+
+                vector<set<int>> rem;
+                vector<pair<set<int>, set<int>>> add;
+                for(const set<int>& Y : P) {
+                    set<int> i, d;
+                    set_intersection(Y.begin(), Y.end(), X.begin(), X.end(), inserter(i, i.begin()));
+                    set_difference(Y.begin(), Y.end(), X.begin(), X.end(), inserter(d, d.begin()));
+                    if(!i.empty() && !d.empty()) {
+                        rem.push_back(Y); add.push_back({i, d});
+                        if(W.count(Y)) { W.erase(Y); W.insert(i); W.insert(d); }
+                        else { if(i.size() <= d.size()) W.insert(i); else W.insert(d); }
+                    }
+                }
+                for(auto& r : rem) P.erase(r);
+                for(auto& a : add) { P.insert(a.first); P.insert(a.second); }
+            }
+        }
+        
+        return buildFromPartition(dfa, P);
+    }
+};
+
+#endif // HOPCROFT_HPP
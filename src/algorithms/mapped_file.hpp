@@ -0,0 +1,112 @@
+// File ánh xạ bộ nhớ và định dạng nhị phân DFAB, dùng chung cho các chế độ ngoài bộ nhớ
+// (Hopcroft, Moore) và bảng phân biệt mmap của Table Filling.
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstring>
+#include "dfa_core.hpp"
+
+// Ánh xạ toàn bộ một file vào bộ nhớ. File tạm (temporary = true) được tạo với kích
+// thước cho trước và tự xóa khi đóng; hệ điều hành đẩy trang ra đĩa khi vượt RAM.
+// sparse = true: vùng chưa ghi không chiếm đĩa (NTFS sparse file).
+class MappedFile {
+public:
+    MappedFile(const string& path, uint64_t bytes = 0, bool temporary = false, bool sparse = false) {
+        file = CreateFileA(path.c_str(), temporary ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                           FILE_SHARE_READ, NULL, temporary ? CREATE_ALWAYS : OPEN_EXISTING,
+                           temporary ? (FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE) : FILE_ATTRIBUTE_NORMAL,
+                           NULL);
+        if (file == INVALID_HANDLE_VALUE) throw runtime_error("Khong mo duoc file: " + path);
+        if (sparse) {
+            DWORD returned = 0;
+            DeviceIoControl(file, FSCTL_SET_SPARSE, NULL, 0, NULL, 0, &returned, NULL);
+        }
+        if (!temporary) {
+            LARGE_INTEGER file_size;
+            GetFileSizeEx(file, &file_size);
+            bytes = (uint64_t)file_size.QuadPart;
+        }
+        size = bytes;
+        if (size == 0) return;
+        mapping = CreateFileMappingA(file, NULL, temporary ? PAGE_READWRITE : PAGE_READONLY,
+                                     (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFFULL), NULL);
+        if (mapping == NULL) throw runtime_error("Khong anh xa duoc file: " + path);
+        data = MapViewOfFile(mapping, temporary ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+        if (data == nullptr) throw runtime_error("Khong anh xa duoc file: " + path);
+    }
+    ~MappedFile() {
+        if (data) UnmapViewOfFile(data);
+        if (mapping != NULL) CloseHandle(mapping);
+        if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    }
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    template <class T> T* as(uint64_t offset = 0) const { return (T*)((char*)data + offset); }
+    uint64_t bytes() const { return size; }
+
+private:
+    HANDLE file = INVALID_HANDLE_VALUE;
+    HANDLE mapping = NULL;
+    void* data = nullptr;
+    uint64_t size = 0;
+};
+
+// Đường dẫn file tạm riêng cho tiến trình: <dir>/<prefix>_<pid>.tmp
+inline string tempFilePath(const string& dir, const string& prefix) {
+    string base = dir.empty() ? "." : dir;
+    return base + "/" + prefix + "_" + to_string(GetCurrentProcessId()) + ".tmp";
+}
+
+// Giới hạn cứng working set (RSS) của tiến trình; trang ánh xạ vượt giới hạn bị đẩy ra đĩa.
+// Trả về false (kèm cảnh báo ra stderr) nếu hệ điều hành từ chối, khi đó ngân sách RSS
+// không được áp dụng.
+inline bool limitWorkingSet(size_t bytes) {
+    if (SetProcessWorkingSetSizeEx(GetCurrentProcess(), bytes / 4, bytes,
+                                   QUOTA_LIMITS_HARDWS_MAX_ENABLE | QUOTA_LIMITS_HARDWS_MIN_DISABLE))
+        return true;
+    cerr << "WARNING: Khong dat duoc gioi han working set (loi " << GetLastError()
+         << "), ngan sach RSS khong duoc ap dung" << endl;
+    return false;
+}
+
+// Ước lượng tỉ lệ trang của vùng [base, base + bytes) đang nằm trong working set,
+// lấy mẫu tối đa 1024 trang cách đều
+inline double residentPercent(const void* base, uint64_t bytes) {
+    const uint64_t page = 4096;
+    uint64_t pages = (bytes + page - 1) / page;
+    if (pages == 0) return 0.0;
+    uint64_t samples = min<uint64_t>(pages, 1024);
+    vector<PSAPI_WORKING_SET_EX_INFORMATION> info(samples);
+    for (uint64_t i = 0; i < samples; ++i)
+        info[i].VirtualAddress = (PVOID)((const char*)base + (i * pages / samples) * page);
+    if (!QueryWorkingSetEx(GetCurrentProcess(), info.data(), (DWORD)(samples * sizeof(info[0])))) return 0.0;
+    uint64_t resident = 0;
+    for (const auto& p : info) resident += p.VirtualAttributes.Valid;
+    return 100.0 * resident / samples;
+}
+
+inline size_t getPageFaultCount() {
+    PROCESS_MEMORY_COUNTERS_EX pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
+        return pmc.PageFaultCount;
+    }
+    return 0;
+}
+
+// Header của định dạng nhị phân "DFAB" v1 (xem DFA_generator.cpp)
+struct BinaryDFAHeader {
+    char magic[4];
+    uint32_t version, num_states, alphabet_size, start_state;
+    uint32_t reserved[3];
+};
+const uint32_t DFAB_NONE = 0xFFFFFFFFu;
+
+inline bool isBinaryDFA(const string& filename) {
+    ifstream f(filename, ios::binary);
+    char magic[4] = {0, 0, 0, 0};
+    f.read(magic, 4);
+    return f && memcmp(magic, "DFAB", 4) == 0;
+}
+
+#endif // MAPPED_FILE_HPP
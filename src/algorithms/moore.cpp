@@ -4,335 +4,512 @@
 #include <string>
 #include <set>
 #include <map>
+#include <tuple>
 #include <algorithm>
 #include <queue>
+#include <atomic>
+#include <functional>
 #include <iomanip>
 #include <chrono>
 #include <sstream>
 #include <windows.h>
 #include <psapi.h>
-#include "json.hpp" // BẮT BUỘC: File json.hpp phải nằm cùng thư mục
-
-using json = nlohmann::json;
-using namespace std;
-
-// === PHẦN 1: CẤU TRÚC DFA ===
-struct DFA {
-    set<int> states;
-    set<int> alphabet;
-    map<int, map<int, int>> transitions;
-    int start_state = -1;
-    set<int> final_states;
-    
-    map<int, string> state_id_to_name;
-    map<string, int> state_name_to_id;
-    map<int, string> input_id_to_char;
-    map<string, int> input_char_to_id;
-    int state_counter = 0;
-    int input_counter = 0;
-
-    int getStateID(string name) {
-        if (state_name_to_id.find(name) == state_name_to_id.end()) {
-            state_name_to_id[name] = state_counter;
-            state_id_to_name[state_counter] = name;
-            states.insert(state_counter);
-            state_counter++;
-        }
-        return state_name_to_id[name];
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+#include <memory>
+#include "moore.hpp" // Cấu trúc DFA dùng chung và lớp MooreSolver
+#include "mapped_file.hpp"
+
+// === PHẦN 2b: MOORE NGOÀI BỘ NHỚ (SẮP XẾP NGOÀI) ===
+// Đọc / ghi tuần tự các bản ghi uint32 có độ rộng cố định qua bộ đệm
+class RecordReader {
+public:
+    RecordReader(const string& path, int width, uint64_t offset = 0, size_t buffer_bytes = 1 << 20)
+        : in(path, ios::binary), width(width), buf(max<size_t>(width, buffer_bytes / 4 / width * width)) {
+        if (!in.is_open()) throw runtime_error("Khong mo duoc file: " + path);
+        in.seekg(offset);
     }
-    int getInputID(string char_str) {
-        if (input_char_to_id.find(char_str) == input_char_to_id.end()) {
-            input_char_to_id[char_str] = input_counter;
-            input_id_to_char[input_counter] = char_str;
-            alphabet.insert(input_counter);
-            input_counter++;
+    // Trả về nullptr khi hết dữ liệu
+    const uint32_t* next() {
+        if (pos == len) {
+            in.read((char*)buf.data(), buf.size() * 4);
+            len = (size_t)in.gcount() / 4 / width * width;
+            pos = 0;
+            if (len == 0) return nullptr;
         }
-        return input_char_to_id[char_str];
+        const uint32_t* rec = buf.data() + pos;
+        pos += width;
+        return rec;
+    }
+
+private:
+    ifstream in;
+    int width;
+    vector<uint32_t> buf;
+    size_t pos = 0, len = 0;
+};
+
+class RecordWriter {
+public:
+    RecordWriter(const string& path, int width, size_t buffer_bytes = 1 << 20)
+        : out(path, ios::binary), width(width) {
+        if (!out.is_open()) throw runtime_error("Khong mo duoc file: " + path);
+        buf.reserve(max<size_t>(width, buffer_bytes / 4));
     }
-    void addTransition(string from, string input_char, string to) {
-        int u = getStateID(from);
-        int v = getStateID(to);
-        int c = getInputID(input_char);
-        transitions[u][c] = v;
+    ~RecordWriter() { flush(); }
+    void write(const uint32_t* rec) {
+        buf.insert(buf.end(), rec, rec + width);
+        if (buf.size() + width > buf.capacity()) flush();
     }
-    void setStart(string name) { start_state = getStateID(name); }
-    void addFinal(string name) { final_states.insert(getStateID(name)); }
+    void flush() {
+        out.write((const char*)buf.data(), buf.size() * 4);
+        buf.clear();
+    }
+
+private:
+    ofstream out;
+    int width;
+    vector<uint32_t> buf;
 };
 
-DFA loadDFA_JSON(string filename) {
-    ifstream f(filename);
-    if (!f.is_open()) throw runtime_error("Khong mo duoc file input: " + filename);
-    json j; f >> j;
-    DFA dfa;
-    for (auto& item : j) {
-        string s = item["state_name"];
-        dfa.getStateID(s);
-        if (item.value("is_start", false)) dfa.setStart(s);
-        if (item.value("is_end", false)) dfa.addFinal(s);
-        if (item.contains("transitions")) {
-            for (auto& t : item["transitions"]) 
-                dfa.addTransition(s, t["input"], t["target_state"]);
-        }
+// Sắp xếp ngoài (merge sort) các bản ghi `width` từ uint32, so sánh từ điển trên `key`
+// từ đầu. add() gom bản ghi vào bộ đệm giới hạn bởi budget_bytes, đầy thì sắp xếp và
+// ghi một run ra đĩa; next() trộn các run (tối đa MAX_FAN_IN run một lượt) theo thứ tự tăng.
+class ExternalSorter {
+public:
+    static const size_t MAX_FAN_IN = 64;
+    uint64_t runs_written = 0;
+
+    ExternalSorter(int width, int key, size_t budget_bytes, const string& dir, const string& prefix)
+        : width(width), key(key), budget(budget_bytes), dir(dir), prefix(prefix) {
+        // Mỗi bản ghi chiếm width từ + 1 chỉ số khi sắp xếp
+        capacity = max<size_t>(1, budget / 4 / (width + 1));
+    }
+    ~ExternalSorter() {
+        readers.clear();
+        for (const string& path : runs) remove(path.c_str());
     }
-    return dfa;
-}
 
-void exportDFA_JSON(const DFA& dfa, string filename) {
-    json j_out = json::array();
-    for (int u : dfa.states) {
-        json j_s;
-        j_s["state_name"] = dfa.state_id_to_name.at(u);
-        j_s["is_start"] = (u == dfa.start_state);
-        j_s["is_end"] = (dfa.final_states.count(u) > 0);
-        json j_trans = json::array();
-        if (dfa.transitions.count(u)) {
-            for (auto const& p : dfa.transitions.at(u)) {
-                json t;
-                t["input"] = dfa.input_id_to_char.at(p.first);
-                t["target_state"] = dfa.state_id_to_name.at(p.second);
-                j_trans.push_back(t);
-            }
+    void add(const uint32_t* rec) {
+        if (buffer.empty()) buffer.reserve(capacity * width);
+        buffer.insert(buffer.end(), rec, rec + width);
+        if (buffer.size() == capacity * width) spill();
+    }
+
+    // Bản ghi kế tiếp theo thứ tự tăng, nullptr khi hết
+    const uint32_t* next() {
+        if (!merging) startMerge();
+        if (in_memory) {
+            if (cursor == order.size()) return nullptr;
+            return buffer.data() + (size_t)order[cursor++] * width;
         }
-        j_s["transitions"] = j_trans;
-        j_out.push_back(j_s);
+        if (heap.empty()) return nullptr;
+        size_t r = heap.top().second;
+        heap.pop();
+        current.assign(heads[r], heads[r] + width);
+        advance(r);
+        return current.data();
     }
-    ofstream o(filename); o << std::setw(4) << j_out;
-}
 
-// === PHẦN 2: LOGIC MOORE ===
-class Solver {
 private:
-    DFA removeUnreachable(const DFA& dfa) {
-        DFA clean = dfa; 
-        set<int> reachable; queue<int> q;
-        if (dfa.start_state == -1) return clean; 
-        q.push(dfa.start_state); reachable.insert(dfa.start_state);
-        while(!q.empty()) {
-            int u = q.front(); q.pop();
-            if (dfa.transitions.count(u)) {
-                for (auto const& p : dfa.transitions.at(u)) {
-                    if (!reachable.count(p.second)) {
-                        reachable.insert(p.second); q.push(p.second);
-                    }
-                }
-            }
+    int width, key;
+    size_t budget, capacity;
+    string dir, prefix;
+    vector<uint32_t> buffer, current;
+    vector<uint32_t> order;
+    vector<string> runs;
+    bool merging = false, in_memory = false;
+    size_t cursor = 0;
+    vector<unique_ptr<RecordReader>> readers;
+    vector<const uint32_t*> heads;
+
+    struct HeadGreater {
+        const ExternalSorter* sorter;
+        bool operator()(const pair<const uint32_t*, size_t>& a, const pair<const uint32_t*, size_t>& b) const {
+            return sorter->less(b.first, a.first);
         }
-        clean.states = reachable;
-        set<int> new_finals;
-        for(int s : reachable) if(dfa.final_states.count(s)) new_finals.insert(s);
-        clean.final_states = new_finals;
-        return clean;
+    };
+    priority_queue<pair<const uint32_t*, size_t>, vector<pair<const uint32_t*, size_t>>, HeadGreater> heap{HeadGreater{this}};
+
+    bool less(const uint32_t* a, const uint32_t* b) const {
+        for (int i = 0; i < key; ++i) if (a[i] != b[i]) return a[i] < b[i];
+        return false;
+    }
+
+    void sortBuffer() {
+        order.resize(buffer.size() / width);
+        for (size_t i = 0; i < order.size(); ++i) order[i] = (uint32_t)i;
+        sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return less(buffer.data() + (size_t)a * width, buffer.data() + (size_t)b * width);
+        });
     }
 
-    // Hàm tái tạo DFA từ phân hoạch (Dùng chung logic tái tạo)
-    DFA reconstructDFA(const DFA& oldDFA, const vector<int>& group_id, int num_groups) {
-        DFA newDFA;
-        newDFA.input_char_to_id = oldDFA.input_char_to_id;
-        newDFA.input_id_to_char = oldDFA.input_id_to_char;
-        newDFA.alphabet = oldDFA.alphabet;
-
-        // Xây dựng map: group_id -> danh sách các trạng thái cũ
-        map<int, vector<int>> groups;
-        for(int u : oldDFA.states) {
-            groups[group_id[u]].push_back(u);
+    string runPath(uint64_t id) { return tempFilePath(dir, prefix + "_run" + to_string(id)); }
+
+    void spill() {
+        sortBuffer();
+        string path = runPath(runs_written++);
+        {
+            RecordWriter out(path, width);
+            for (uint32_t i : order) out.write(buffer.data() + (size_t)i * width);
         }
+        runs.push_back(path);
+        buffer.clear();
+        order.clear();
+    }
 
-        map<int, string> new_group_names;
-
-        for(auto const& pair : groups) {
-            int g_id = pair.first;
-            const vector<int>& members = pair.second;
-            
-            // Tạo tên: {A,B,C}
-            string name = "{";
-            vector<string> names;
-            bool is_s = false, is_f = false;
-            int rep = members[0]; // Đại diện để lấy transition
-
-            for(int u : members) {
-                names.push_back(oldDFA.state_id_to_name.at(u));
-                if(u == oldDFA.start_state) is_s = true;
-                if(oldDFA.final_states.count(u)) is_f = true;
-            }
-            sort(names.begin(), names.end());
-            for(size_t i=0; i<names.size(); ++i) name += (i==0?"":",") + names[i];
-            name += "}";
-
-            newDFA.getStateID(name);
-            if(is_s) newDFA.setStart(name);
-            if(is_f) newDFA.addFinal(name);
-            new_group_names[g_id] = name;
+    void openRuns(const vector<string>& paths) {
+        readers.clear(); heads.clear();
+        while (!heap.empty()) heap.pop();
+        size_t per_run = max<size_t>(4096, budget / (paths.size() + 1));
+        for (size_t r = 0; r < paths.size(); ++r) {
+            readers.emplace_back(new RecordReader(paths[r], width, 0, per_run));
+            heads.push_back(nullptr);
+            advance(r);
         }
+    }
 
-        // Tạo transitions
-        for(auto const& pair : groups) {
-            int g_id = pair.first;
-            int rep = pair.second[0];
-            string src_name = new_group_names[g_id];
-
-            if(oldDFA.transitions.count(rep)) {
-                for(auto const& t : oldDFA.transitions.at(rep)) {
-                    int input = t.first;
-                    int target_old = t.second;
-                    int target_group = group_id[target_old];
-                    newDFA.addTransition(src_name, newDFA.input_id_to_char[input], new_group_names[target_group]);
+    void advance(size_t r) {
+        heads[r] = readers[r]->next();
+        if (heads[r]) heap.push({heads[r], r});
+    }
+
+    void startMerge() {
+        merging = true;
+        if (runs.empty()) {
+            // Vừa bộ đệm: sắp xếp trong RAM, không ghi đĩa
+            in_memory = true;
+            sortBuffer();
+            return;
+        }
+        if (!buffer.empty()) spill();
+        vector<uint32_t>().swap(buffer);
+        // Trộn nhiều lượt cho tới khi còn tối đa MAX_FAN_IN run
+        while (runs.size() > MAX_FAN_IN) {
+            vector<string> merged;
+            for (size_t i = 0; i < runs.size(); i += MAX_FAN_IN) {
+                vector<string> group(runs.begin() + i, runs.begin() + min(runs.size(), i + MAX_FAN_IN));
+                openRuns(group);
+                string path = runPath(runs_written++);
+                {
+                    RecordWriter out(path, width);
+                    while (!heap.empty()) {
+                        size_t r = heap.top().second;
+                        heap.pop();
+                        out.write(heads[r]);
+                        advance(r);
+                    }
                 }
+                readers.clear();
+                for (const string& p : group) remove(p.c_str());
+                merged.push_back(path);
             }
+            runs = merged;
         }
-        return newDFA;
+        openRuns(runs);
     }
+};
 
+// Đọc tuần tự bitmap chấp nhận của file DFAB, mỗi lần một trạng thái
+class AcceptReader {
 public:
-    DFA minimize(DFA inputDFA) {
-        // 1. Loại bỏ trạng thái thừa
-        DFA dfa = removeUnreachable(inputDFA);
-        if (dfa.states.empty()) return dfa;
+    AcceptReader(const string& path, uint64_t offset) : in(path, ios::binary), buf(1 << 16) {
+        if (!in.is_open()) throw runtime_error("Khong mo duoc file: " + path);
+        in.seekg(offset);
+    }
+    uint32_t next() {
+        if (bit == 8 * len) {
+            in.read((char*)buf.data(), buf.size());
+            len = (size_t)in.gcount();
+            bit = 0;
+            if (len == 0) throw runtime_error("File DFAB bi cat cut (bitmap chap nhan)");
+        }
+        uint32_t value = (buf[bit / 8] >> (bit % 8)) & 1;
+        bit++;
+        return value;
+    }
+
+private:
+    ifstream in;
+    vector<uint8_t> buf;
+    size_t bit = 0, len = 0;
+};
 
-        int n = dfa.state_counter; // Max ID + 1
-        vector<int> group(n, -1);
+// Moore trên DFA nhị phân lớn hơn RAM, chỉ dùng I/O tuần tự. group[] nằm trên đĩa
+// (mỗi trạng thái một uint32, theo thứ tự trạng thái). Mỗi vòng:
+//  1. Nối cạnh (đã sắp theo đích, dựng một lần) với group[] -> (nguồn, c, group[đích]);
+//  2. sắp theo (nguồn, c), ghép với group[] và bitmap chấp nhận thành chữ ký
+//     (group[u], group[δ(u,0)], ..., group[δ(u,k-1)], u, accept);
+//  3. sắp theo chữ ký, gán ID khối mới bằng một lượt quét (ID = hạng của chữ ký);
+//  4. sắp (u, ID) theo u và ghi lại group[] tuần tự.
+// Dừng khi số khối không tăng. ID luôn là hạng liên tục 0..B-1 và chữ ký bắt đầu bằng
+// ID cũ, nên ở vòng cuối ID mới trùng ID cũ và các cột group[đích] của chữ ký chính là
+// hàng của DFA tối thiểu. Trạng thái không tới được vẫn tham gia tinh chỉnh (tương đương
+// không phụ thuộc tính tới được); writeResult chỉ ghi các khối tới được từ khối bắt đầu.
+class ExternalMoore {
+public:
+    SolverControl control;
+    size_t memory_budget_bytes = (size_t)1024 << 20;
+    string temp_dir;
+
+    uint64_t num_states = 0, alphabet_size = 0, num_transitions = 0;
+    uint32_t result_states = 0;
+    int rounds = 0;
+    uint64_t runs_written = 0;
+
+    void minimize(const string& inputFile, const string& outputFile) {
+        BinaryDFAHeader header;
+        {
+            ifstream in(inputFile, ios::binary);
+            if (!in.is_open()) throw runtime_error("Khong mo duoc file input: " + inputFile);
+            in.read((char*)&header, sizeof(header));
+            if (!in || memcmp(header.magic, "DFAB", 4) != 0 || header.version != 1)
+                throw runtime_error("File DFAB khong hop le: " + inputFile);
+        }
+        uint64_t n = header.num_states, k = header.alphabet_size;
+        num_states = n; alphabet_size = k;
+        uint64_t accept_offset = sizeof(BinaryDFAHeader) + n * k * 4;
+        size_t sorter_budget = max<size_t>(64 << 10, memory_budget_bytes / 3);
+
+        // Cạnh (đích, nguồn, c) sắp theo đích: dùng lại ở mọi vòng
+        string edges_path = tempFilePath(temp_dir, "moore_edges");
+        string group_path = tempFilePath(temp_dir, "moore_group");
+        string rows_path = tempFilePath(temp_dir, "moore_rows");
+        string accept_path = tempFilePath(temp_dir, "moore_accept");
+        struct Cleanup {
+            vector<string> paths;
+            ~Cleanup() { for (const string& p : paths) remove(p.c_str()); }
+        } cleanup{{edges_path, group_path, rows_path, accept_path}};
+
+        {
+            ExternalSorter edges(3, 1, sorter_budget, temp_dir, "moore_edges_sort");
+            RecordReader rows(inputFile, (int)k, sizeof(BinaryDFAHeader));
+            num_transitions = 0;
+            for (uint64_t u = 0; u < n; ++u) {
+                const uint32_t* row = rows.next();
+                for (uint64_t c = 0; c < k; ++c) {
+                    if (row[c] == DFAB_NONE) continue;
+                    uint32_t rec[3] = {row[c], (uint32_t)u, (uint32_t)c};
+                    edges.add(rec);
+                    num_transitions++;
+                }
+            }
+            RecordWriter out(edges_path, 3);
+            for (const uint32_t* rec = edges.next(); rec; rec = edges.next()) out.write(rec);
+            runs_written += edges.runs_written;
+        }
 
-        // 2. Khởi tạo P0: 2 nhóm (Final và Non-Final)
-        for(int u : dfa.states) {
-            group[u] = dfa.final_states.count(u) ? 1 : 0;
+        // P0: {không chấp nhận, chấp nhận} với ID liên tục
+        uint64_t accepting_count = 0;
+        {
+            AcceptReader accept(inputFile, accept_offset);
+            for (uint64_t u = 0; u < n; ++u) accepting_count += accept.next();
+        }
+        uint32_t blocks = (accepting_count == 0 || accepting_count == n) ? 1 : 2;
+        {
+            AcceptReader accept(inputFile, accept_offset);
+            RecordWriter out(group_path, 1);
+            for (uint64_t u = 0; u < n; ++u) {
+                uint32_t g = (blocks == 2 && accept.next()) ? 1 : 0;
+                out.write(&g);
+            }
         }
 
-        // 3. Vòng lặp tinh chỉnh (Refinement Loop)
-        bool changed = true;
-        while(changed) {
-            changed = false;
-            map<vector<int>, int> signature_to_id;
-            int next_group_count = 0;
-            vector<int> new_group(n);
-
-            // Duyệt qua tất cả trạng thái để tính chữ ký mới
-            for(int u : dfa.states) {
-                vector<int> signature;
-                signature.push_back(group[u]); // ID nhóm hiện tại
-                
-                // Thêm ID nhóm của các trạng thái đích
-                for(int c : dfa.alphabet) {
-                    int target = -1;
-                    if(dfa.transitions[u].count(c)) {
-                        target = dfa.transitions[u][c];
-                    }
-                    // Nếu có chuyển đổi thì lấy ID nhóm đích, nếu không thì -1
-                    signature.push_back(target != -1 ? group[target] : -1);
+        SolverProgress progress;
+        progress.blocks = blocks;
+        rounds = 0;
+        vector<uint32_t> sig(k + 3);
+        while (n > 0) {
+            control.poll(progress);
+            rounds++;
+
+            // 1-2. Nối cạnh với group[] rồi ghép chữ ký theo nguồn
+            ExternalSorter joined(3, 2, sorter_budget, temp_dir, "moore_join");
+            {
+                RecordReader edges(edges_path, 3), group(group_path, 1);
+                uint64_t u = 0;
+                const uint32_t* g = group.next();
+                for (const uint32_t* e = edges.next(); e; e = edges.next()) {
+                    while (u < e[0]) { g = group.next(); u++; }
+                    uint32_t rec[3] = {e[1], e[2], *g};
+                    joined.add(rec);
                 }
-
-                // Gán ID nhóm mới dựa trên chữ ký
-                if(signature_to_id.find(signature) == signature_to_id.end()) {
-                    signature_to_id[signature] = next_group_count++;
+            }
+            ExternalSorter signatures((int)k + 3, (int)k + 1, sorter_budget, temp_dir, "moore_sig");
+            {
+                RecordReader group(group_path, 1);
+                AcceptReader accept(inputFile, accept_offset);
+                const uint32_t* j = joined.next();
+                for (uint64_t u = 0; u < n; ++u) {
+                    sig[0] = *group.next();
+                    fill(sig.begin() + 1, sig.begin() + 1 + k, DFAB_NONE);
+                    for (; j && j[0] == u; j = joined.next()) sig[1 + j[1]] = j[2];
+                    sig[k + 1] = (uint32_t)u;
+                    sig[k + 2] = accept.next();
+                    signatures.add(sig.data());
                 }
-                new_group[u] = signature_to_id[signature];
             }
 
-            // Kiểm tra xem có sự thay đổi nào về phân hoạch không
-            // So sánh vector cũ và mới trên tập các trạng thái hợp lệ
-            for(int u : dfa.states) {
-                if(group[u] != new_group[u]) {
-                    // Cần kiểm tra kỹ hơn: liệu số lượng nhóm có tăng lên không?
-                    // Hoặc đơn giản là lặp cho đến khi vector không đổi
+            // 3. Gán ID mới theo hạng chữ ký; ghi hàng ứng viên của DFA tối thiểu
+            ExternalSorter relabel(2, 1, sorter_budget, temp_dir, "moore_relabel");
+            uint32_t new_blocks = 0;
+            {
+                RecordWriter rows(rows_path, (int)k), accepts(accept_path, 1);
+                vector<uint32_t> prev(k + 1);
+                for (const uint32_t* s = signatures.next(); s; s = signatures.next()) {
+                    if (new_blocks == 0 || !equal(s, s + k + 1, prev.begin())) {
+                        copy(s, s + k + 1, prev.begin());
+                        new_blocks++;
+                        rows.write(s + 1);
+                        accepts.write(s + k + 2);
+                    }
+                    uint32_t rec[2] = {s[k + 1], new_blocks - 1};
+                    relabel.add(rec);
                 }
             }
-            
-            // Cách đơn giản nhất để check sự thay đổi: so sánh số lượng nhóm
-            // Tuy nhiên, để chính xác nhất, ta so sánh toàn bộ vector (hoặc check sự phân tách)
-            // Ở đây ta dùng cách gán và check cờ:
-            if (new_group != group) {
-                group = new_group;
-                changed = true;
+            runs_written += joined.runs_written + signatures.runs_written;
+
+            // 4. Ghi lại group[] theo thứ tự trạng thái
+            {
+                RecordWriter group(group_path, 1);
+                for (const uint32_t* r = relabel.next(); r; r = relabel.next()) group.write(r + 1);
             }
+            runs_written += relabel.runs_written;
+
+            progress.rounds = rounds;
+            progress.blocks = new_blocks;
+            bool changed = new_blocks != blocks;
+            blocks = new_blocks;
+            if (!changed) break;
         }
 
-        // 4. Tái tạo DFA
-        return reconstructDFA(dfa, group, 0);
+        writeResult(outputFile, n > 0 ? blocks : 0, header, group_path, rows_path, accept_path);
     }
-};
 
-// === PHẦN 3: HÀM MAIN ===
-
-// Hàm lấy memory usage (Windows)
-size_t getCurrentMemoryUsage() {
-    PROCESS_MEMORY_COUNTERS_EX pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
-        return pmc.WorkingSetSize / 1024; // Convert to KB
+private:
+    // BFS trên DFA thương từ khối bắt đầu (như ExternalHopcroft::writeResult): chỉ ghi khối
+    // tới được, đánh số lại theo thứ tự BFS. Hàng thương và bảng đánh số nằm trên file ánh xạ.
+    void writeResult(const string& outputFile, uint32_t blocks, const BinaryDFAHeader& input,
+                     const string& group_path, const string& rows_path, const string& accept_path) {
+        uint64_t k = alphabet_size;
+        BinaryDFAHeader header = {{'D', 'F', 'A', 'B'}, 1, 0, (uint32_t)k, 0, {0, 0, 0}};
+        result_states = 0;
+        ofstream out(outputFile, ios::binary);
+        if (!out.is_open()) throw runtime_error("Khong mo duoc file output: " + outputFile);
+        out.write((const char*)&header, sizeof(header));
+        if (blocks == 0 || input.start_state >= num_states) return;
+
+        uint32_t start_block;
+        {
+            ifstream group(group_path, ios::binary);
+            group.seekg((uint64_t)input.start_state * 4);
+            group.read((char*)&start_block, 4);
+        }
+        MappedFile rows(rows_path), accepts(accept_path);
+        MappedFile order_file(tempFilePath(temp_dir, "moore_order"), (uint64_t)blocks * 8, true);
+        const uint32_t* row_data = rows.as<uint32_t>();
+        const uint32_t* accept_data = accepts.as<uint32_t>();
+        uint32_t* new_id = order_file.as<uint32_t>();      // khối -> id BFS
+        uint32_t* queue = new_id + blocks;                  // id BFS -> khối
+        for (uint32_t b = 0; b < blocks; ++b) new_id[b] = DFAB_NONE;
+        new_id[start_block] = 0;
+        queue[result_states++] = start_block;
+        vector<uint32_t> row(k);
+        vector<uint8_t> accept_bits;
+        for (uint32_t i = 0; i < result_states; ++i) {
+            uint32_t b = queue[i];
+            for (uint64_t c = 0; c < k; ++c) {
+                uint32_t t = row_data[(uint64_t)b * k + c];
+                if (t == DFAB_NONE) { row[c] = DFAB_NONE; continue; }
+                if (new_id[t] == DFAB_NONE) { new_id[t] = result_states; queue[result_states++] = t; }
+                row[c] = new_id[t];
+            }
+            out.write((const char*)row.data(), k * 4);
+            if (i % 8 == 0) accept_bits.push_back(0);
+            if (accept_data[b]) accept_bits.back() |= (uint8_t)(1u << (i % 8));
+        }
+        out.write((const char*)accept_bits.data(), accept_bits.size());
+        header.num_states = result_states;
+        header.start_state = 0;
+        out.seekp(0);
+        out.write((const char*)&header, sizeof(header));
     }
-    return 0;
-}
+};
 
-size_t getPeakMemoryUsage() {
-    PROCESS_MEMORY_COUNTERS_EX pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
-        return pmc.PeakWorkingSetSize / 1024; // Convert to KB
-    }
+// === PHẦN 3: HÀM MAIN ===
+// Chế độ out-of-core: input và output ở định dạng nhị phân DFAB, chỉ I/O tuần tự
+int runExternal(const string& inputFile, const string& outputFile, double memBudgetMB,
+                const string& tempDir, const SolverControl& control) {
+    // DFAB chỉ lưu bảng chuyển và một bit chấp nhận: không nhận JSON (có thể mang
+    // accept_class / output) để tránh bỏ ngầm các trường đó
+    if (!isBinaryDFA(inputFile))
+        throw runtime_error("--external chi nhan file DFAB (khong luu accept_class / output): " + inputFile);
+    getCPUUsage();
+    string testCaseLabel = extractTestCaseLabel(inputFile);
+    ExternalMoore solver;
+    solver.control = control;
+    solver.memory_budget_bytes = (size_t)(memBudgetMB * 1024 * 1024);
+    solver.temp_dir = tempDir;
+
+    size_t faultsBefore = getPageFaultCount();
+    auto start = chrono::high_resolution_clock::now();
+    solver.minimize(inputFile, outputFile);
+    auto end = chrono::high_resolution_clock::now();
+    size_t pageFaults = getPageFaultCount() - faultsBefore;
+    double wallTimeMs = chrono::duration_cast<chrono::microseconds>(end - start).count() / 1000.0;
+
+    cout << "Test_Case_Label: " << testCaseLabel << endl;
+    cout << "Initial_States: " << solver.num_states << endl;
+    cout << "Final_States: " << solver.result_states << endl;
+    cout << "Alphabet_Size: " << solver.alphabet_size << endl;
+    cout << "Transitions: " << solver.num_transitions << endl;
+    cout << "Rounds: " << solver.rounds << endl;
+    cout << "Sort_Runs: " << solver.runs_written << endl;
+    cout << "Memory_Budget_MB: " << fixed << setprecision(0) << memBudgetMB << endl;
+    cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
+    cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << getCPUUsage() << endl;
+    cout << "Memory_Usage_KB: " << getCurrentMemoryUsage() << endl;
+    cout << "Peak_Memory_KB: " << getPeakMemoryUsage() << endl;
+    cout << "Page_Faults: " << pageFaults << endl;
     return 0;
 }
 
-// Hàm lấy CPU usage (Windows)
-double getCPUUsage() {
-    static ULARGE_INTEGER lastCPU, lastSysCPU, lastUserCPU;
-    static int numProcessors;
-    static HANDLE self;
-    static bool initialized = false;
-
-    if (!initialized) {
-        SYSTEM_INFO sysInfo;
-        FILETIME ftime, fsys, fuser;
-        GetSystemInfo(&sysInfo);
-        numProcessors = sysInfo.dwNumberOfProcessors;
-        GetSystemTimeAsFileTime(&ftime);
-        memcpy(&lastCPU, &ftime, sizeof(FILETIME));
-        self = GetCurrentProcess();
-        GetProcessTimes(self, &ftime, &ftime, &fsys, &fuser);
-        memcpy(&lastSysCPU, &fsys, sizeof(FILETIME));
-        memcpy(&lastUserCPU, &fuser, sizeof(FILETIME));
-        initialized = true;
-        return 0.0;
-    }
-
-    FILETIME ftime, fsys, fuser;
-    ULARGE_INTEGER now, sys, user;
-    double percent;
-
-    GetSystemTimeAsFileTime(&ftime);
-    memcpy(&now, &ftime, sizeof(FILETIME));
-    GetProcessTimes(self, &ftime, &ftime, &fsys, &fuser);
-    memcpy(&sys, &fsys, sizeof(FILETIME));
-    memcpy(&user, &fuser, sizeof(FILETIME));
-    
-    percent = (sys.QuadPart - lastSysCPU.QuadPart) + (user.QuadPart - lastUserCPU.QuadPart);
-    percent /= (now.QuadPart - lastCPU.QuadPart);
-    percent /= numProcessors;
-    
-    lastCPU = now;
-    lastUserCPU = user;
-    lastSysCPU = sys;
-
-    return percent * 100.0;
-}
-
-// Hàm trích xuất test case label từ filename
-string extractTestCaseLabel(const string& filename) {
-    // Extract from filename like "1000_states_dfa.json" -> "1000"
-    size_t pos = filename.find_last_of("/\\");
-    string basename = (pos == string::npos) ? filename : filename.substr(pos + 1);
-    
-    // Try to extract number at the beginning
-    size_t underscore = basename.find('_');
-    if (underscore != string::npos) {
-        return basename.substr(0, underscore);
-    }
-    
-    // If no underscore, return basename without extension
-    size_t dot = basename.find_last_of('.');
-    return (dot == string::npos) ? basename : basename.substr(0, dot);
-}
-
 int main(int argc, char* argv[]) {
     string inputFile = (argc > 1) ? argv[1] : "50000_states_dfa.json";
     string outputFile = (argc > 2) ? argv[2] : "output.json";
+    string truthFile;
+    bool printHash = false;
+    double deadlineMs = 0; // 0 = không giới hạn
+    bool printProgress = false;
+    bool external = false; // Tự bật khi input là file nhị phân DFAB
+    double memBudgetMB = 1024;
+    string tempDir;
+    for (int i = 3; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--truth" && i + 1 < argc) truthFile = argv[++i];
+        else if (arg == "--hash") printHash = true;
+        else if (arg == "--deadline-ms" && i + 1 < argc) deadlineMs = stod(argv[++i]);
+        else if (arg == "--progress") printProgress = true;
+        else if (arg == "--external") external = true;
+        else if (arg == "--mem-budget-mb" && i + 1 < argc) memBudgetMB = stod(argv[++i]);
+        else if (arg == "--temp-dir" && i + 1 < argc) tempDir = argv[++i];
+    }
 
     try {
+        if (external || isBinaryDFA(inputFile)) {
+            SolverControl control;
+            if (deadlineMs > 0)
+                control.deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(deadlineMs * 1000));
+            if (printProgress) {
+                control.on_progress = [](const SolverProgress& p) {
+                    cerr << "Progress: rounds=" << p.rounds << " blocks=" << p.blocks
+                         << " marked_pairs=" << p.marked_pairs << " worklist=" << p.worklist << endl;
+                };
+            }
+            return runExternal(inputFile, outputFile, memBudgetMB, tempDir, control);
+        }
+
         // Initialize CPU monitoring
         getCPUUsage();
         
@@ -347,9 +524,23 @@ int main(int argc, char* argv[]) {
         auto start = chrono::high_resolution_clock::now();
         size_t memBefore = getCurrentMemoryUsage();
         
-        // Run minimization
-        Solver solver;
-        DFA minDFA = solver.minimize(myDFA);
+        // Run minimization (trên bảng chữ cái đã nén, sau khi gộp các hàng trùng nhau)
+        AlphabetClasses alphabetClasses;
+        DFA reducedDFA = compressAlphabet(myDFA, alphabetClasses);
+        RowMerge rowMerge;
+        DFA dedupDFA = mergeDuplicateRows(reducedDFA, rowMerge);
+        MooreSolver solver;
+        if (deadlineMs > 0)
+            solver.control.deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(deadlineMs * 1000));
+        if (printProgress) {
+            solver.control.on_progress = [](const SolverProgress& p) {
+                cerr << "Progress: rounds=" << p.rounds << " blocks=" << p.blocks
+                     << " marked_pairs=" << p.marked_pairs << " worklist=" << p.worklist << endl;
+            };
+        }
+        DFA minDFA = solver.minimize(dedupDFA);
+        minDFA = restoreMergedStates(minDFA, dedupDFA, reducedDFA, rowMerge);
+        minDFA = expandAlphabet(minDFA, alphabetClasses);
         
         // End timing and memory measurement
         auto end = chrono::high_resolution_clock::now();
@@ -361,6 +552,9 @@ int main(int argc, char* argv[]) {
         auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
         double wallTimeMs = duration.count() / 1000.0;
         int finalStates = minDFA.states.size();
+
+        // Đánh số lại theo BFS để kết quả không phụ thuộc thứ tự duyệt của solver
+        minDFA = canonicalizeDFA(minDFA);
         size_t memoryUsage = memAfter;
         
         // Export result
@@ -370,14 +564,25 @@ int main(int argc, char* argv[]) {
         cout << "Test_Case_Label: " << testCaseLabel << endl;
         cout << "Initial_States: " << initialStates << endl;
         cout << "Final_States: " << finalStates << endl;
+        cout << "Alphabet_Size: " << alphabetClasses.original_size << endl;
+        cout << "Alphabet_Classes: " << reducedDFA.alphabet.size() << endl;
+        cout << "Dedup_States: " << dedupDFA.states.size() << endl;
+        cout << "Dedup_Passes: " << rowMerge.passes << endl;
         cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
         cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << cpuUsage << endl;
         cout << "Memory_Usage_KB: " << memoryUsage << endl;
         cout << "Peak_Memory_KB: " << peakMem << endl;
+        if (!truthFile.empty())
+            cout << "Ground_Truth_Check: " << checkGroundTruth(minDFA, truthFile) << endl;
+        if (printHash)
+            cout << "Canonical_Hash: " << canonicalHash(minDFA) << endl;
         
+    } catch (const SolverCancelled& e) {
+        cerr << "CANCELLED: " << e.what() << endl;
+        return 3;
     } catch (const exception& e) {
         cerr << "ERROR: " << e.what() << endl;
         return 1;
     }
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,175 @@
+// Moore trong bộ nhớ: lớp MooreSolver.
+// Dùng chung giữa moore.cpp (main riêng) và portfolio.cpp.
+#ifndef MOORE_HPP
+#define MOORE_HPP
+
+#include "dfa_core.hpp"
+
+// === PHẦN 2: LOGIC MOORE ===
+class MooreSolver {
+private:
+    DFA removeUnreachable(const DFA& dfa) {
+        DFA clean = dfa; 
+        set<int> reachable; queue<int> q;
+        if (dfa.start_state == -1) return clean; 
+        q.push(dfa.start_state); reachable.insert(dfa.start_state);
+        while(!q.empty()) {
+            int u = q.front(); q.pop();
+            if (dfa.transitions.count(u)) {
+                for (auto const& p : dfa.transitions.at(u)) {
+                    if (!reachable.count(p.second)) {
+                        reachable.insert(p.second); q.push(p.second);
+                    }
+                }
+            }
+        }
+        clean.states = reachable;
+        set<int> new_finals;
+        for(int s : reachable) if(dfa.final_states.count(s)) new_finals.insert(s);
+        clean.final_states = new_finals;
+        return clean;
+    }
+
+    // Hàm tái tạo DFA từ phân hoạch (Dùng chung logic tái tạo)
+    DFA reconstructDFA(const DFA& oldDFA, const vector<int>& group_id, int num_groups) {
+        DFA newDFA;
+        newDFA.input_char_to_id = oldDFA.input_char_to_id;
+        newDFA.input_id_to_char = oldDFA.input_id_to_char;
+        newDFA.alphabet = oldDFA.alphabet;
+
+        // Xây dựng map: group_id -> danh sách các trạng thái cũ
+        map<int, vector<int>> groups;
+        for(int u : oldDFA.states) {
+            groups[group_id[u]].push_back(u);
+        }
+
+        map<int, string> new_group_names;
+
+        for(auto const& pair : groups) {
+            int g_id = pair.first;
+            const vector<int>& members = pair.second;
+            
+            // Tạo tên: {A,B,C}
+            string name = "{";
+            vector<string> names;
+            bool is_s = false, is_f = false;
+            int rep = members[0]; // Đại diện để lấy transition
+            auto cls = oldDFA.accept_class.end(); // Mọi trạng thái trong nhóm cùng nhãn
+
+            for(int u : members) {
+                names.push_back(oldDFA.state_id_to_name.at(u));
+                if(u == oldDFA.start_state) is_s = true;
+                if(oldDFA.final_states.count(u)) is_f = true;
+                if(oldDFA.accept_class.count(u)) cls = oldDFA.accept_class.find(u);
+            }
+            sort(names.begin(), names.end());
+            for(size_t i=0; i<names.size(); ++i) name += (i==0?"":",") + names[i];
+            name += "}";
+
+            newDFA.getStateID(name);
+            if(is_s) newDFA.setStart(name);
+            if(is_f) newDFA.addFinal(name);
+            if(cls != oldDFA.accept_class.end()) newDFA.setAcceptClass(name, cls->second);
+            new_group_names[g_id] = name;
+        }
+
+        // Tạo transitions
+        for(auto const& pair : groups) {
+            int g_id = pair.first;
+            int rep = pair.second[0];
+            string src_name = new_group_names[g_id];
+
+            if(oldDFA.transitions.count(rep)) {
+                for(auto const& t : oldDFA.transitions.at(rep)) {
+                    int input = t.first;
+                    int target_old = t.second;
+                    int target_group = group_id[target_old];
+                    newDFA.addTransition(src_name, newDFA.input_id_to_char[input], new_group_names[target_group]);
+                }
+            }
+            if(oldDFA.transition_output.count(rep)) {
+                for(auto const& o : oldDFA.transition_output.at(rep))
+                    newDFA.setOutput(src_name, newDFA.input_id_to_char[o.first], o.second);
+            }
+        }
+        return newDFA;
+    }
+
+public:
+    // Hủy / deadline / tiến độ, được kiểm tra ở ranh giới mỗi vòng tinh chỉnh
+    SolverControl control;
+
+    DFA minimize(DFA inputDFA) {
+        // 1. Loại bỏ trạng thái thừa
+        DFA dfa = removeUnreachable(inputDFA);
+        if (dfa.states.empty()) return dfa;
+
+        int n = dfa.state_counter; // Max ID + 1
+        vector<int> group(n, -1);
+
+        // 2. Khởi tạo P0: một nhóm cho mỗi nhãn đầu ra (Final / Non-Final, hoặc accept_class)
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        for(int u : dfa.states) {
+            group[u] = label[u];
+        }
+
+        // 3. Vòng lặp tinh chỉnh (Refinement Loop)
+        bool changed = true;
+        SolverProgress progress;
+        progress.blocks = num_labels;
+        while(changed) {
+            control.poll(progress);
+            changed = false;
+            map<vector<int>, int> signature_to_id;
+            int next_group_count = 0;
+            vector<int> new_group(n);
+
+            // Duyệt qua tất cả trạng thái để tính chữ ký mới
+            for(int u : dfa.states) {
+                vector<int> signature;
+                signature.push_back(group[u]); // ID nhóm hiện tại
+                
+                // Thêm ID nhóm của các trạng thái đích
+                for(int c : dfa.alphabet) {
+                    int target = -1;
+                    if(dfa.transitions[u].count(c)) {
+                        target = dfa.transitions[u][c];
+                    }
+                    // Nếu có chuyển đổi thì lấy ID nhóm đích, nếu không thì -1
+                    signature.push_back(target != -1 ? group[target] : -1);
+                }
+
+                // Gán ID nhóm mới dựa trên chữ ký
+                if(signature_to_id.find(signature) == signature_to_id.end()) {
+                    signature_to_id[signature] = next_group_count++;
+                }
+                new_group[u] = signature_to_id[signature];
+            }
+
+            // Kiểm tra xem có sự thay đổi nào về phân hoạch không
+            // So sánh vector cũ và mới trên tập các trạng thái hợp lệ
+            for(int u : dfa.states) {
+                if(group[u] != new_group[u]) {
+                    // Cần kiểm tra kỹ hơn: liệu số lượng nhóm có tăng lên không?
+                    // Hoặc đơn giản là lặp cho đến khi vector không đổi
+                }
+            }
+            
+            // Cách đơn giản nhất để check sự thay đổi: so sánh số lượng nhóm
+            // Tuy nhiên, để chính xác nhất, ta so sánh toàn bộ vector (hoặc check sự phân tách)
+            // Ở đây ta dùng cách gán và check cờ:
+            if (new_group != group) {
+                group = new_group;
+                changed = true;
+            }
+            progress.rounds++;
+            progress.blocks = next_group_count;
+        }
+
+        // 4. Tái tạo DFA
+        return reconstructDFA(dfa, group, 0);
+    }
+};
+
+#endif // MOORE_HPP
@@ -0,0 +1,228 @@
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <set>
+#include <map>
+#include <algorithm>
+#include <queue>
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iomanip>
+#include <chrono>
+#include <sstream>
+#include <windows.h>
+#include <psapi.h>
+#include <cstdint>
+
+// Portfolio: chạy song song mọi engine trên cùng một DFA (chỉ đọc), lấy kết quả của
+// engine xong trước và hủy hợp tác các engine còn lại (control của từng solver).
+// Mỗi solver khai báo lớp của mình trong header riêng trên nền dfa_core.hpp.
+#include "hopcroft.hpp"
+#include "moore.hpp"
+#include "table_filling.hpp"
+#include "brzozowski.hpp"
+
+// === PHẦN 2: LOGIC PORTFOLIO ===
+class Portfolio {
+private:
+    size_t memory_budget_bytes;
+    chrono::steady_clock::time_point deadline;
+
+    atomic<bool> cancel{false};
+    mutex mtx;
+    condition_variable cv;
+    int running = 0;
+    bool has_winner = false;
+    DFA winner;
+    string winner_engine;
+    vector<string> errors;
+    vector<thread> threads;
+
+    template <class S>
+    void launch(const string& name, const DFA& core, S solver) {
+        running++;
+        started.push_back(name);
+        threads.emplace_back([this, name, &core, solver]() mutable {
+            solver.control.cancel_flag = &cancel;
+            solver.control.deadline = deadline;
+            try {
+                DFA result = solver.minimize(core);
+                lock_guard<mutex> lock(mtx);
+                if (!has_winner) {
+                    has_winner = true;
+                    winner = move(result);
+                    winner_engine = name;
+                    cancel = true;
+                }
+            } catch (const SolverCancelled& e) {
+                if (!cancel) {
+                    lock_guard<mutex> lock(mtx);
+                    errors.push_back(name + ": " + e.what());
+                }
+            } catch (const exception& e) {
+                lock_guard<mutex> lock(mtx);
+                errors.push_back(name + ": " + e.what());
+            }
+            lock_guard<mutex> lock(mtx);
+            running--;
+            cv.notify_all();
+        });
+    }
+
+    static bool isComplete(const DFA& dfa) {
+        for (int u : dfa.states) {
+            auto it = dfa.transitions.find(u);
+            if (it == dfa.transitions.end() || it->second.size() < dfa.alphabet.size()) return false;
+        }
+        return true;
+    }
+
+public:
+    vector<string> started, skipped;
+
+    Portfolio(size_t budget, chrono::steady_clock::time_point deadline_)
+        : memory_budget_bytes(budget), deadline(deadline_) {}
+
+    // Trả về (tên engine thắng, DFA kết quả)
+    pair<string, DFA> run(const DFA& core) {
+        launch("hopcroft", core, HopcroftSolver());
+        launch("moore", core, MooreSolver());
+
+        // Bảng marked của table filling (backend tiled): hai ma trận n x ceil(n / 64) word
+        size_t n = core.state_counter;
+        size_t table_bytes = n * ((n + 63) / 64) * 16;
+        if (table_bytes <= memory_budget_bytes) {
+            TableFillingSolver table_filling;
+            table_filling.table_backend = "tiled";
+            launch("table_filling", core, table_filling);
+        } else {
+            skipped.push_back("table_filling");
+        }
+
+        // Brzozowski chỉ đua khi DFA đầy đủ: với DFA bộ phận, kết quả (và --hash) không được
+        // phụ thuộc engine nào xong trước
+        if (isComplete(core)) {
+            BrzozowskiSolver brzozowski;
+            brzozowski.memory_budget_bytes = memory_budget_bytes;
+            launch("brzozowski", core, brzozowski);
+        } else {
+            skipped.push_back("brzozowski");
+        }
+
+        {
+            unique_lock<mutex> lock(mtx);
+            cv.wait(lock, [this]() { return has_winner || running == 0; });
+        }
+        cancel = true;
+        for (thread& t : threads) t.join();
+
+        if (!has_winner && chrono::steady_clock::now() > deadline)
+            throw SolverCancelled("Portfolio vuot qua deadline");
+        if (!has_winner) {
+            string msg = "Khong engine nao hoan thanh";
+            for (const string& e : errors) msg += "; " + e;
+            throw runtime_error(msg);
+        }
+        return {winner_engine, move(winner)};
+    }
+};
+
+// === PHẦN 3: HÀM MAIN ===
+string joinNames(const vector<string>& names) {
+    string out;
+    for (size_t i = 0; i < names.size(); ++i) out += (i == 0 ? "" : ",") + names[i];
+    return out.empty() ? "-" : out;
+}
+
+int main(int argc, char* argv[]) {
+    string inputFile = (argc > 1) ? argv[1] : "50000_states_dfa.json";
+    string outputFile = (argc > 2) ? argv[2] : "output.json";
+    string truthFile;
+    bool printHash = false;
+    double deadlineMs = 0; // 0 = không giới hạn
+    double memBudgetMB = 1024;
+    for (int i = 3; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--truth" && i + 1 < argc) truthFile = argv[++i];
+        else if (arg == "--hash") printHash = true;
+        else if (arg == "--deadline-ms" && i + 1 < argc) deadlineMs = stod(argv[++i]);
+        else if (arg == "--mem-budget-mb" && i + 1 < argc) memBudgetMB = stod(argv[++i]);
+    }
+
+    try {
+        // Initialize CPU monitoring
+        getCPUUsage();
+
+        // Load DFA
+        DFA myDFA = loadDFA_JSON(inputFile);
+        int initialStates = myDFA.states.size();
+
+        // Extract test case label
+        string testCaseLabel = extractTestCaseLabel(inputFile);
+
+        // Start timing and memory measurement
+        auto start = chrono::high_resolution_clock::now();
+
+        // Tiền xử lý một lần, các engine dùng chung dedupDFA
+        AlphabetClasses alphabetClasses;
+        DFA reducedDFA = compressAlphabet(myDFA, alphabetClasses);
+        RowMerge rowMerge;
+        DFA dedupDFA = mergeDuplicateRows(reducedDFA, rowMerge);
+        auto deadline = (deadlineMs > 0)
+            ? chrono::steady_clock::now() + chrono::microseconds((long long)(deadlineMs * 1000))
+            : chrono::steady_clock::time_point::max();
+        Portfolio portfolio((size_t)(memBudgetMB * 1024 * 1024), deadline);
+        pair<string, DFA> result = portfolio.run(dedupDFA);
+        DFA minDFA = restoreMergedStates(result.second, dedupDFA, reducedDFA, rowMerge);
+        minDFA = expandAlphabet(minDFA, alphabetClasses);
+
+        // End timing and memory measurement
+        auto end = chrono::high_resolution_clock::now();
+        size_t memAfter = getCurrentMemoryUsage();
+        size_t peakMem = getPeakMemoryUsage();
+        double cpuUsage = getCPUUsage();
+
+        // Calculate metrics
+        auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
+        double wallTimeMs = duration.count() / 1000.0;
+        int finalStates = minDFA.states.size();
+
+        // Đánh số lại theo BFS để kết quả không phụ thuộc engine thắng
+        minDFA = canonicalizeDFA(minDFA);
+
+        // Export result
+        exportDFA_JSON(minDFA, outputFile);
+
+        // Display metrics in required format
+        cout << "Test_Case_Label: " << testCaseLabel << endl;
+        cout << "Initial_States: " << initialStates << endl;
+        cout << "Final_States: " << finalStates << endl;
+        cout << "Alphabet_Size: " << alphabetClasses.original_size << endl;
+        cout << "Alphabet_Classes: " << reducedDFA.alphabet.size() << endl;
+        cout << "Dedup_States: " << dedupDFA.states.size() << endl;
+        cout << "Dedup_Passes: " << rowMerge.passes << endl;
+        cout << "Winner_Engine: " << result.first << endl;
+        cout << "Engines_Started: " << joinNames(portfolio.started) << endl;
+        cout << "Engines_Skipped: " << joinNames(portfolio.skipped) << endl;
+        cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
+        cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << cpuUsage << endl;
+        cout << "Memory_Usage_KB: " << memAfter << endl;
+        cout << "Peak_Memory_KB: " << peakMem << endl;
+        if (!truthFile.empty())
+            cout << "Ground_Truth_Check: " << checkGroundTruth(minDFA, truthFile) << endl;
+        if (printHash)
+            cout << "Canonical_Hash: " << canonicalHash(minDFA) << endl;
+
+    } catch (const SolverCancelled& e) {
+        cerr << "CANCELLED: " << e.what() << endl;
+        return 3;
+    } catch (const exception& e) {
+        cerr << "ERROR: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -4,341 +4,46 @@
 #include <string>
 #include <set>
 #include <map>
+#include <tuple>
 #include <algorithm>
 #include <queue>
+#include <atomic>
+#include <functional>
 #include <iomanip>
 #include <chrono>
 #include <sstream>
 #include <windows.h>
 #include <psapi.h>
-#include "json.hpp" 
-
-using json = nlohmann::json;
-using namespace std;
-
-// === PHẦN 1: CẤU TRÚC DFA ===
-struct DFA {
-    set<int> states;
-    set<int> alphabet;
-    map<int, map<int, int>> transitions;
-    int start_state = -1;
-    set<int> final_states;
-    
-    map<int, string> state_id_to_name;
-    map<string, int> state_name_to_id;
-    map<int, string> input_id_to_char;
-    map<string, int> input_char_to_id;
-    int state_counter = 0;
-    int input_counter = 0;
-
-    int getStateID(string name) {
-        if (state_name_to_id.find(name) == state_name_to_id.end()) {
-            state_name_to_id[name] = state_counter;
-            state_id_to_name[state_counter] = name;
-            states.insert(state_counter);
-            state_counter++;
-        }
-        return state_name_to_id[name];
-    }
-    int getInputID(string char_str) {
-        if (input_char_to_id.find(char_str) == input_char_to_id.end()) {
-            input_char_to_id[char_str] = input_counter;
-            input_id_to_char[input_counter] = char_str;
-            alphabet.insert(input_counter);
-            input_counter++;
-        }
-        return input_char_to_id[char_str];
-    }
-    void addTransition(string from, string input_char, string to) {
-        int u = getStateID(from);
-        int v = getStateID(to);
-        int c = getInputID(input_char);
-        transitions[u][c] = v;
-    }
-    void setStart(string name) { start_state = getStateID(name); }
-    void addFinal(string name) { final_states.insert(getStateID(name)); }
-};
-
-DFA loadDFA_JSON(string filename) {
-    ifstream f(filename);
-    if (!f.is_open()) throw runtime_error("Khong mo duoc file input: " + filename);
-    json j; f >> j;
-    DFA dfa;
-    for (auto& item : j) {
-        string s = item["state_name"];
-        dfa.getStateID(s);
-        if (item.value("is_start", false)) dfa.setStart(s);
-        if (item.value("is_end", false)) dfa.addFinal(s);
-        if (item.contains("transitions")) {
-            for (auto& t : item["transitions"]) 
-                dfa.addTransition(s, t["input"], t["target_state"]);
-        }
-    }
-    return dfa;
-}
-
-void exportDFA_JSON(const DFA& dfa, string filename) {
-    json j_out = json::array();
-    for (int u : dfa.states) {
-        json j_s;
-        j_s["state_name"] = dfa.state_id_to_name.at(u);
-        j_s["is_start"] = (u == dfa.start_state);
-        j_s["is_end"] = (dfa.final_states.count(u) > 0);
-        json j_trans = json::array();
-        if (dfa.transitions.count(u)) {
-            for (auto const& p : dfa.transitions.at(u)) {
-                json t;
-                t["input"] = dfa.input_id_to_char.at(p.first);
-                t["target_state"] = dfa.state_id_to_name.at(p.second);
-                j_trans.push_back(t);
-            }
-        }
-        j_s["transitions"] = j_trans;
-        j_out.push_back(j_s);
-    }
-    ofstream o(filename); o << std::setw(4) << j_out;
-}
-
-// === PHẦN 2: LOGIC TABLE FILLING ===
-class Solver {
-private:
-    DFA removeUnreachable(const DFA& dfa) {
-        DFA clean = dfa; 
-        set<int> reachable; queue<int> q;
-        if (dfa.start_state == -1) return clean; 
-        q.push(dfa.start_state); reachable.insert(dfa.start_state);
-        while(!q.empty()) {
-            int u = q.front(); q.pop();
-            if (dfa.transitions.count(u)) {
-                for (auto const& p : dfa.transitions.at(u)) {
-                    if (!reachable.count(p.second)) {
-                        reachable.insert(p.second); q.push(p.second);
-                    }
-                }
-            }
-        }
-        clean.states = reachable;
-        set<int> new_finals;
-        for(int s : reachable) if(dfa.final_states.count(s)) new_finals.insert(s);
-        clean.final_states = new_finals;
-        return clean;
-    }
-    
-    // Hàm tái tạo DFA dùng chung logic tái tạo nhóm
-    DFA reconstructDFA(const DFA& oldDFA, const vector<int>& group_id) {
-        DFA newDFA;
-        newDFA.input_char_to_id = oldDFA.input_char_to_id;
-        newDFA.input_id_to_char = oldDFA.input_id_to_char;
-        newDFA.alphabet = oldDFA.alphabet;
-
-        map<int, vector<int>> groups;
-        for(int u : oldDFA.states) groups[group_id[u]].push_back(u);
-
-        map<int, string> new_group_names;
-
-        for(auto const& pair : groups) {
-            int g_id = pair.first;
-            string name = "{";
-            vector<string> names;
-            bool is_s = false, is_f = false;
-            for(int u : pair.second) {
-                names.push_back(oldDFA.state_id_to_name.at(u));
-                if(u == oldDFA.start_state) is_s = true;
-                if(oldDFA.final_states.count(u)) is_f = true;
-            }
-            sort(names.begin(), names.end());
-            for(size_t i=0; i<names.size(); ++i) name += (i==0?"":",") + names[i];
-            name += "}";
-
-            newDFA.getStateID(name);
-            if(is_s) newDFA.setStart(name);
-            if(is_f) newDFA.addFinal(name);
-            new_group_names[g_id] = name;
-        }
-
-        for(auto const& pair : groups) {
-            int g_id = pair.first;
-            int rep = pair.second[0];
-            string src_name = new_group_names[g_id];
-            if(oldDFA.transitions.count(rep)) {
-                for(auto const& t : oldDFA.transitions.at(rep)) {
-                    newDFA.addTransition(src_name, newDFA.input_id_to_char[t.first], new_group_names[group_id[t.second]]);
-                }
-            }
-        }
-        return newDFA;
-    }
-
-public:
-    DFA minimize(DFA inputDFA) {
-        DFA dfa = removeUnreachable(inputDFA);
-        if (dfa.states.empty()) return dfa;
-
-        int n = dfa.state_counter;
-        // Bảng đánh dấu: marked[u][v] = true nếu u và v phân biệt
-        vector<vector<bool>> marked(n, vector<bool>(n, false));
-
-        // 1. Bước cơ sở: Đánh dấu cặp (Final, Non-Final)
-        for(int i : dfa.states) {
-            for(int j : dfa.states) {
-                if(i < j) {
-                    bool f1 = dfa.final_states.count(i);
-                    bool f2 = dfa.final_states.count(j);
-                    if(f1 != f2) marked[i][j] = true;
-                }
-            }
-        }
-
-        // 2. Vòng lặp: Đánh dấu nếu chuyển đến cặp đã đánh dấu
-        bool changed = true;
-        while(changed) {
-            changed = false;
-            for(int i : dfa.states) {
-                for(int j : dfa.states) {
-                    if(i < j && !marked[i][j]) {
-                        for(int c : dfa.alphabet) {
-                            int t1 = -1, t2 = -1;
-                            if(dfa.transitions[i].count(c)) t1 = dfa.transitions[i][c];
-                            if(dfa.transitions[j].count(c)) t2 = dfa.transitions[j][c];
-                            
-                            // Nếu một cái có cạnh, một cái không -> Phân biệt
-                            if((t1 == -1 && t2 != -1) || (t1 != -1 && t2 == -1)) {
-                                marked[i][j] = true;
-                                changed = true;
-                                break;
-                            }
-                            
-                            // Nếu cả hai chuyển đến cặp đã mark
-                            if(t1 != -1 && t2 != -1) {
-                                int u = min(t1, t2);
-                                int v = max(t1, t2);
-                                if(u != v && marked[u][v]) {
-                                    marked[i][j] = true;
-                                    changed = true;
-                                    break;
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-
-        // 3. Gom nhóm các trạng thái tương đương (BFS/DFS trên các cặp chưa mark)
-        vector<int> group(n, -1);
-        int group_count = 0;
-        
-        for(int i : dfa.states) {
-            if(group[i] == -1) {
-                group[i] = group_count;
-                // Tìm tất cả j tương đương với i
-                queue<int> q; q.push(i);
-                while(!q.empty()) {
-                    int u = q.front(); q.pop();
-                    for(int v : dfa.states) {
-                        if(group[v] == -1) {
-                            int min_uv = min(u, v);
-                            int max_uv = max(u, v);
-                            if(min_uv == max_uv) continue;
-                            
-                            // Nếu không bị đánh dấu -> Tương đương
-                            if(!marked[min_uv][max_uv]) {
-                                group[v] = group_count;
-                                q.push(v);
-                            }
-                        }
-                    }
-                }
-                group_count++;
-            }
-        }
-
-        return reconstructDFA(dfa, group);
-    }
-};
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include "table_filling.hpp" // Cấu trúc DFA dùng chung và lớp TableFillingSolver
 
 // === PHẦN 3: HÀM MAIN ===
-
-// Hàm lấy memory usage (Windows)
-size_t getCurrentMemoryUsage() {
-    PROCESS_MEMORY_COUNTERS_EX pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
-        return pmc.WorkingSetSize / 1024; // Convert to KB
-    }
-    return 0;
-}
-
-size_t getPeakMemoryUsage() {
-    PROCESS_MEMORY_COUNTERS_EX pmc;
-    if (GetProcessMemoryInfo(GetCurrentProcess(), (PROCESS_MEMORY_COUNTERS*)&pmc, sizeof(pmc))) {
-        return pmc.PeakWorkingSetSize / 1024; // Convert to KB
-    }
-    return 0;
-}
-
-// Hàm lấy CPU usage (Windows)
-double getCPUUsage() {
-    static ULARGE_INTEGER lastCPU, lastSysCPU, lastUserCPU;
-    static int numProcessors;
-    static HANDLE self;
-    static bool initialized = false;
-
-    if (!initialized) {
-        SYSTEM_INFO sysInfo;
-        FILETIME ftime, fsys, fuser;
-        GetSystemInfo(&sysInfo);
-        numProcessors = sysInfo.dwNumberOfProcessors;
-        GetSystemTimeAsFileTime(&ftime);
-        memcpy(&lastCPU, &ftime, sizeof(FILETIME));
-        self = GetCurrentProcess();
-        GetProcessTimes(self, &ftime, &ftime, &fsys, &fuser);
-        memcpy(&lastSysCPU, &fsys, sizeof(FILETIME));
-        memcpy(&lastUserCPU, &fuser, sizeof(FILETIME));
-        initialized = true;
-        return 0.0;
-    }
-
-    FILETIME ftime, fsys, fuser;
-    ULARGE_INTEGER now, sys, user;
-    double percent;
-
-    GetSystemTimeAsFileTime(&ftime);
-    memcpy(&now, &ftime, sizeof(FILETIME));
-    GetProcessTimes(self, &ftime, &ftime, &fsys, &fuser);
-    memcpy(&sys, &fsys, sizeof(FILETIME));
-    memcpy(&user, &fuser, sizeof(FILETIME));
-    
-    percent = (sys.QuadPart - lastSysCPU.QuadPart) + (user.QuadPart - lastUserCPU.QuadPart);
-    percent /= (now.QuadPart - lastCPU.QuadPart);
-    percent /= numProcessors;
-    
-    lastCPU = now;
-    lastUserCPU = user;
-    lastSysCPU = sys;
-
-    return percent * 100.0;
-}
-
-// Hàm trích xuất test case label từ filename
-string extractTestCaseLabel(const string& filename) {
-    // Extract from filename like "1000_states_dfa.json" -> "1000"
-    size_t pos = filename.find_last_of("/\\");
-    string basename = (pos == string::npos) ? filename : filename.substr(pos + 1);
-    
-    // Try to extract number at the beginning
-    size_t underscore = basename.find('_');
-    if (underscore != string::npos) {
-        return basename.substr(0, underscore);
-    }
-    
-    // If no underscore, return basename without extension
-    size_t dot = basename.find_last_of('.');
-    return (dot == string::npos) ? basename : basename.substr(0, dot);
-}
-
 int main(int argc, char* argv[]) {
     string inputFile = (argc > 1) ? argv[1] : "50000_states_dfa.json";
     string outputFile = (argc > 2) ? argv[2] : "output.json";
+    string truthFile;
+    bool printHash = false;
+    double deadlineMs = 0; // 0 = không giới hạn
+    bool printProgress = false;
+    string tableBackend = "auto"; // memory | tiled | blocked | mmap | auto
+    int threads = 1; // Backend tiled, 0 = số lõi của máy
+    int coarseRounds = 2; // Backend blocked
+    double memBudgetMB = 1024;
+    string tempDir;
+    for (int i = 3; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--truth" && i + 1 < argc) truthFile = argv[++i];
+        else if (arg == "--hash") printHash = true;
+        else if (arg == "--deadline-ms" && i + 1 < argc) deadlineMs = stod(argv[++i]);
+        else if (arg == "--progress") printProgress = true;
+        else if (arg == "--table" && i + 1 < argc) tableBackend = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = stoi(argv[++i]);
+        else if (arg == "--coarse-rounds" && i + 1 < argc) coarseRounds = stoi(argv[++i]);
+        else if (arg == "--mem-budget-mb" && i + 1 < argc) memBudgetMB = stod(argv[++i]);
+        else if (arg == "--temp-dir" && i + 1 < argc) tempDir = argv[++i];
+    }
 
     try {
         // Initialize CPU monitoring
@@ -355,9 +60,29 @@ int main(int argc, char* argv[]) {
         auto start = chrono::high_resolution_clock::now();
         size_t memBefore = getCurrentMemoryUsage();
         
-        // Run minimization
-        Solver solver;
-        DFA minDFA = solver.minimize(myDFA);
+        // Run minimization (trên bảng chữ cái đã nén, sau khi gộp các hàng trùng nhau)
+        AlphabetClasses alphabetClasses;
+        DFA reducedDFA = compressAlphabet(myDFA, alphabetClasses);
+        RowMerge rowMerge;
+        DFA dedupDFA = mergeDuplicateRows(reducedDFA, rowMerge);
+        TableFillingSolver solver;
+        solver.table_backend = tableBackend;
+        solver.threads = (threads > 0) ? threads : max(1, (int)thread::hardware_concurrency());
+        solver.coarse_rounds = coarseRounds;
+        solver.memory_budget_bytes = (size_t)(memBudgetMB * 1024 * 1024);
+        solver.temp_dir = tempDir;
+        size_t faultsBefore = getPageFaultCount();
+        if (deadlineMs > 0)
+            solver.control.deadline = chrono::steady_clock::now() + chrono::microseconds((long long)(deadlineMs * 1000));
+        if (printProgress) {
+            solver.control.on_progress = [](const SolverProgress& p) {
+                cerr << "Progress: rounds=" << p.rounds << " blocks=" << p.blocks
+                     << " marked_pairs=" << p.marked_pairs << " worklist=" << p.worklist << endl;
+            };
+        }
+        DFA minDFA = solver.minimize(dedupDFA);
+        minDFA = restoreMergedStates(minDFA, dedupDFA, reducedDFA, rowMerge);
+        minDFA = expandAlphabet(minDFA, alphabetClasses);
         
         // End timing and memory measurement
         auto end = chrono::high_resolution_clock::now();
@@ -369,6 +94,9 @@ int main(int argc, char* argv[]) {
         auto duration = chrono::duration_cast<chrono::microseconds>(end - start);
         double wallTimeMs = duration.count() / 1000.0;
         int finalStates = minDFA.states.size();
+
+        // Đánh số lại theo BFS để kết quả không phụ thuộc thứ tự duyệt của solver
+        minDFA = canonicalizeDFA(minDFA);
         size_t memoryUsage = memAfter;
         
         // Export result
@@ -378,14 +106,37 @@ int main(int argc, char* argv[]) {
         cout << "Test_Case_Label: " << testCaseLabel << endl;
         cout << "Initial_States: " << initialStates << endl;
         cout << "Final_States: " << finalStates << endl;
+        cout << "Alphabet_Size: " << alphabetClasses.original_size << endl;
+        cout << "Alphabet_Classes: " << reducedDFA.alphabet.size() << endl;
+        cout << "Dedup_States: " << dedupDFA.states.size() << endl;
+        cout << "Dedup_Passes: " << rowMerge.passes << endl;
+        cout << "Table_Backend: " << solver.used_backend << endl;
+        if (solver.used_backend == "tiled") cout << "Threads: " << solver.threads << endl;
+        if (solver.used_backend == "blocked") {
+            cout << "Coarse_Rounds: " << solver.coarse_rounds << endl;
+            cout << "Coarse_Blocks: " << solver.coarse_blocks << endl;
+            cout << "Table_MB: " << fixed << setprecision(2) << solver.table_bytes / (1024.0 * 1024.0) << endl;
+        }
+        if (solver.used_backend == "mmap") {
+            cout << "Table_MB: " << fixed << setprecision(2) << solver.table_bytes / (1024.0 * 1024.0) << endl;
+            cout << "Table_Resident_Percent: " << fixed << setprecision(2) << solver.table_resident_percent << endl;
+            cout << "Page_Faults: " << getPageFaultCount() - faultsBefore << endl;
+        }
         cout << "Wall_Time_ms: " << fixed << setprecision(3) << wallTimeMs << endl;
         cout << "CPU_Usage_Percent: " << fixed << setprecision(2) << cpuUsage << endl;
         cout << "Memory_Usage_KB: " << memoryUsage << endl;
         cout << "Peak_Memory_KB: " << peakMem << endl;
+        if (!truthFile.empty())
+            cout << "Ground_Truth_Check: " << checkGroundTruth(minDFA, truthFile) << endl;
+        if (printHash)
+            cout << "Canonical_Hash: " << canonicalHash(minDFA) << endl;
         
+    } catch (const SolverCancelled& e) {
+        cerr << "CANCELLED: " << e.what() << endl;
+        return 3;
     } catch (const exception& e) {
         cerr << "ERROR: " << e.what() << endl;
         return 1;
     }
     return 0;
-}
\ No newline at end of file
+}
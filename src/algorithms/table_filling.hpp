@@ -0,0 +1,559 @@
+// Table Filling: các bảng phân biệt (bộ nhớ, tiled, mmap) và lớp TableFillingSolver.
+// Dùng chung giữa table_filling.cpp (main riêng) và portfolio.cpp.
+#ifndef TABLE_FILLING_HPP
+#define TABLE_FILLING_HPP
+
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "dfa_core.hpp"
+#include "mapped_file.hpp"
+
+// === PHẦN 2: LOGIC TABLE FILLING ===
+// Bảng marked ngoài bộ nhớ: tam giác trên của ma trận cặp, chia thành tile TILE x TILE
+// bit, mỗi tile liên tục trong một file tạm thưa được ánh xạ bộ nhớ.
+// Cặp (i, j) với i < j nằm ở tile (i / TILE, j / TILE).
+struct MappedPairTable {
+    static const uint64_t TILE = 4096; // Bội của 64: mỗi hàng của tile gồm các word trọn vẹn
+    uint64_t n, tiles;
+    MappedFile file;
+    uint64_t* bits;
+
+    MappedPairTable(uint64_t n, const string& dir)
+        : n(n), tiles((n + TILE - 1) / TILE),
+          file(tempFilePath(dir, "table_filling_marked"), max<uint64_t>(8, tiles * (tiles + 1) / 2 * TILE * TILE / 8), true, true),
+          bits(file.as<uint64_t>()) {}
+
+    uint64_t bitIndex(uint64_t i, uint64_t j) const {
+        uint64_t I = i / TILE, J = j / TILE;
+        uint64_t tile = I * tiles - I * (I - 1) / 2 + (J - I);
+        return (tile * TILE + i % TILE) * TILE + j % TILE;
+    }
+    bool get(uint64_t i, uint64_t j) const { uint64_t b = bitIndex(i, j); return (bits[b >> 6] >> (b & 63)) & 1; }
+    void set(uint64_t i, uint64_t j) { uint64_t b = bitIndex(i, j); bits[b >> 6] |= 1ULL << (b & 63); }
+
+    // Gọi f(i, j) cho mọi cặp i < j, lần lượt từng tile (hàng tile rồi cột tile)
+    template <class F>
+    void forEachPairTiled(SolverControl& control, const SolverProgress& progress, F f) {
+        for (uint64_t I = 0; I < tiles; ++I)
+            for (uint64_t J = I; J < tiles; ++J) {
+                control.poll(progress);
+                uint64_t i_end = min(n, (I + 1) * TILE), j_end = min(n, (J + 1) * TILE);
+                for (uint64_t i = I * TILE; i < i_end; ++i)
+                    for (uint64_t j = max(i + 1, J * TILE); j < j_end; ++j) f(i, j);
+            }
+    }
+};
+
+class TableFillingSolver {
+private:
+    DFA removeUnreachable(const DFA& dfa) {
+        DFA clean = dfa; 
+        set<int> reachable; queue<int> q;
+        if (dfa.start_state == -1) return clean; 
+        q.push(dfa.start_state); reachable.insert(dfa.start_state);
+        while(!q.empty()) {
+            int u = q.front(); q.pop();
+            if (dfa.transitions.count(u)) {
+                for (auto const& p : dfa.transitions.at(u)) {
+                    if (!reachable.count(p.second)) {
+                        reachable.insert(p.second); q.push(p.second);
+                    }
+                }
+            }
+        }
+        clean.states = reachable;
+        set<int> new_finals;
+        for(int s : reachable) if(dfa.final_states.count(s)) new_finals.insert(s);
+        clean.final_states = new_finals;
+        return clean;
+    }
+    
+    // Hàm tái tạo DFA dùng chung logic tái tạo nhóm
+    DFA reconstructDFA(const DFA& oldDFA, const vector<int>& group_id) {
+        DFA newDFA;
+        newDFA.input_char_to_id = oldDFA.input_char_to_id;
+        newDFA.input_id_to_char = oldDFA.input_id_to_char;
+        newDFA.alphabet = oldDFA.alphabet;
+
+        map<int, vector<int>> groups;
+        for(int u : oldDFA.states) groups[group_id[u]].push_back(u);
+
+        map<int, string> new_group_names;
+
+        for(auto const& pair : groups) {
+            int g_id = pair.first;
+            string name = "{";
+            vector<string> names;
+            bool is_s = false, is_f = false;
+            auto cls = oldDFA.accept_class.end(); // Mọi trạng thái trong nhóm cùng nhãn
+            for(int u : pair.second) {
+                names.push_back(oldDFA.state_id_to_name.at(u));
+                if(u == oldDFA.start_state) is_s = true;
+                if(oldDFA.final_states.count(u)) is_f = true;
+                if(oldDFA.accept_class.count(u)) cls = oldDFA.accept_class.find(u);
+            }
+            sort(names.begin(), names.end());
+            for(size_t i=0; i<names.size(); ++i) name += (i==0?"":",") + names[i];
+            name += "}";
+
+            newDFA.getStateID(name);
+            if(is_s) newDFA.setStart(name);
+            if(is_f) newDFA.addFinal(name);
+            if(cls != oldDFA.accept_class.end()) newDFA.setAcceptClass(name, cls->second);
+            new_group_names[g_id] = name;
+        }
+
+        for(auto const& pair : groups) {
+            int g_id = pair.first;
+            int rep = pair.second[0];
+            string src_name = new_group_names[g_id];
+            if(oldDFA.transitions.count(rep)) {
+                for(auto const& t : oldDFA.transitions.at(rep)) {
+                    newDFA.addTransition(src_name, newDFA.input_id_to_char[t.first], new_group_names[group_id[t.second]]);
+                }
+            }
+            if(oldDFA.transition_output.count(rep)) {
+                for(auto const& o : oldDFA.transition_output.at(rep))
+                    newDFA.setOutput(src_name, newDFA.input_id_to_char[o.first], o.second);
+            }
+        }
+        return newDFA;
+    }
+
+    // Gom nhóm bằng union-find (nén đường đi) trên m trạng thái đánh số 0..m-1:
+    // quét theo hàng, unmarked(i, j) với i < j cho biết cặp chưa bị đánh dấu. Tương đương
+    // có tính bắc cầu nên chỉ hàng của đại diện (trạng thái nhỏ nhất trong lớp) được quét;
+    // hàng của trạng thái đã có đại diện bị bỏ qua hoàn toàn, tổng chi phí O(số lớp * m).
+    // Lớp được đánh số theo thứ tự đại diện, giống thứ tự gom nhóm BFS trước đây.
+    template <class Unmarked>
+    vector<int> groupByUnionFind(size_t m, Unmarked unmarked, SolverProgress& progress) {
+        vector<int> parent(m);
+        for (size_t i = 0; i < m; ++i) parent[i] = (int)i;
+        auto find = [&](int x) {
+            while (parent[x] != x) { parent[x] = parent[parent[x]]; x = parent[x]; }
+            return x;
+        };
+        vector<int> group(m, -1);
+        int group_count = 0;
+        for (size_t i = 0; i < m; ++i) {
+            if (find((int)i) != (int)i) continue;
+            progress.blocks = group_count;
+            control.poll(progress);
+            group[i] = group_count++;
+            for (size_t j = i + 1; j < m; ++j)
+                if (parent[j] == (int)j && unmarked(i, j)) parent[j] = (int)i;
+        }
+        for (size_t i = 0; i < m; ++i) group[i] = group[find((int)i)];
+        return group;
+    }
+
+    // Table filling song song trên ma trận bit đầy đủ (đối xứng) trong RAM, mỗi hàng
+    // words = ceil(m / 64) word. Ma trận tam giác trên được chia thành tile TILE x TILE bit
+    // (căn theo word); các luồng nhận tile qua bộ đếm nguyên tử. Mỗi vòng đọc cur và ghi
+    // next (double buffer): tile (I, J) chỉ ghi các word của chính nó và của tile đối xứng
+    // (J, I), nên không có hai luồng nào ghi cùng một word.
+    // Đánh dấu theo word: với hàng i và ký tự c, các cặp (i, j) của một word có cặp đích
+    // (δ(i,c), δ(j,c)) cùng nằm trên hàng δ(i,c) của cur; cạnh thiếu được xử lý bằng mặt nạ
+    // has[c] cho cả 64 cặp một lúc, và chỉ các bit chưa đánh dấu mới phải tra bảng.
+    vector<int> groupTiled(DFA& dfa, int num_threads) {
+        const uint64_t TILE = 1024;
+        const size_t POLL_TILES = 8; // Mỗi worker kiểm tra hủy / deadline sau từng ấy tile
+        vector<int> ids(dfa.states.begin(), dfa.states.end());
+        uint64_t m = ids.size(), words = (m + 63) / 64;
+        int k = dfa.input_counter;
+        vector<int> index(dfa.state_counter, -1);
+        for (uint64_t i = 0; i < m; ++i) index[ids[i]] = (int)i;
+        vector<int> trans(m * k, -1);
+        // label_bits[l]: các trạng thái mang nhãn đầu ra l
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        vector<uint64_t> label_bits((size_t)num_labels * words, 0), has((size_t)k * words, 0);
+        for (uint64_t i = 0; i < m; ++i) {
+            label_bits[(size_t)label[ids[i]] * words + i / 64] |= 1ULL << (i % 64);
+            for (auto const& p : dfa.transitions[ids[i]]) {
+                trans[i * k + p.first] = index[p.second];
+                has[(size_t)p.first * words + i / 64] |= 1ULL << (i % 64);
+            }
+        }
+        auto validMask = [&](uint64_t w) { return (w + 1 == words && m % 64) ? (1ULL << (m % 64)) - 1 : ~0ULL; };
+
+        vector<uint64_t> cur(m * words), next(m * words);
+        table_bytes = (cur.size() + next.size()) * sizeof(uint64_t);
+        SolverProgress progress;
+
+        // 1. Bước cơ sở: cặp khác nhãn đầu ra, cả 64 cặp một lúc
+        for (uint64_t i = 0; i < m; ++i) {
+            const uint64_t* same = label_bits.data() + (size_t)label[ids[i]] * words;
+            for (uint64_t w = 0; w < words; ++w)
+                cur[i * words + w] = ~same[w] & validMask(w);
+        }
+        vector<uint64_t>().swap(label_bits);
+        for (uint64_t x : cur) progress.marked_pairs += __builtin_popcountll(x);
+        progress.marked_pairs /= 2;
+
+        // 2. Các vòng song song cho tới khi không còn cặp mới
+        uint64_t tiles = (m + TILE - 1) / TILE;
+        vector<pair<uint64_t, uint64_t>> tasks;
+        for (uint64_t I = 0; I < tiles; ++I)
+            for (uint64_t J = I; J < tiles; ++J) tasks.push_back({I, J});
+
+        auto runTile = [&](uint64_t I, uint64_t J, long long& newly) {
+            uint64_t i_end = min(m, (I + 1) * TILE), j_end = min(m, (J + 1) * TILE);
+            uint64_t w_begin = J * TILE / 64, w_end = (j_end + 63) / 64;
+            uint64_t mw_begin = I * TILE / 64, mw_end = (i_end + 63) / 64;
+            // Sao chép tile và tile đối xứng từ cur sang next
+            for (uint64_t i = I * TILE; i < i_end; ++i)
+                copy(cur.begin() + i * words + w_begin, cur.begin() + i * words + w_end, next.begin() + i * words + w_begin);
+            if (I != J)
+                for (uint64_t j = J * TILE; j < j_end; ++j)
+                    copy(cur.begin() + j * words + mw_begin, cur.begin() + j * words + mw_end, next.begin() + j * words + mw_begin);
+
+            for (uint64_t i = I * TILE; i < i_end; ++i) {
+                const uint64_t* row = cur.data() + i * words;
+                for (uint64_t w = w_begin; w < w_end; ++w) {
+                    // Chỉ xét j > i trong tile; các bit đã đánh dấu không cần tra
+                    if (w * 64 + 63 <= i) continue;
+                    uint64_t upper = (w * 64 > i) ? ~0ULL : ~0ULL << (i % 64 + 1);
+                    uint64_t todo = upper & validMask(w) & ~row[w];
+                    if (!todo) continue;
+                    uint64_t hit = 0;
+                    for (int c = 0; c < k && todo & ~hit; ++c) {
+                        int t1 = trans[i * k + c];
+                        uint64_t has_c = has[(size_t)c * words + w];
+                        if (t1 == -1) { hit |= todo & has_c; continue; }
+                        hit |= todo & ~has_c;
+                        const uint64_t* target_row = cur.data() + (uint64_t)t1 * words;
+                        for (uint64_t bits = todo & has_c & ~hit; bits; bits &= bits - 1) {
+                            uint64_t j = w * 64 + __builtin_ctzll(bits);
+                            uint64_t t2 = (uint64_t)trans[j * k + c];
+                            if ((uint64_t)t1 != t2 && ((target_row[t2 / 64] >> (t2 % 64)) & 1))
+                                hit |= 1ULL << (j % 64);
+                        }
+                    }
+                    if (!hit) continue;
+                    next[i * words + w] |= hit;
+                    newly += __builtin_popcountll(hit);
+                    // Ghi đối xứng vào tile (J, I)
+                    for (uint64_t bits = hit; bits; bits &= bits - 1) {
+                        uint64_t j = w * 64 + __builtin_ctzll(bits);
+                        next[j * words + i / 64] |= 1ULL << (i % 64);
+                    }
+                }
+            }
+        };
+
+        bool changed = true;
+        mutex poll_mtx; // poll gọi on_progress và ghi last_report: không cho hai worker chạy cùng lúc
+        while (changed) {
+            control.poll(progress);
+            atomic<size_t> next_task{0};
+            atomic<long long> newly_total{0};
+            atomic<bool> stop{false};
+            exception_ptr failure;
+            // Worker tự poll giữa các tile; khi một worker bị hủy, các worker khác thôi nhận tile
+            auto worker = [&]() {
+                long long newly = 0;
+                size_t done = 0;
+                for (size_t t = next_task++; t < tasks.size() && !stop.load(memory_order_relaxed); t = next_task++) {
+                    runTile(tasks[t].first, tasks[t].second, newly);
+                    if (++done % POLL_TILES) continue;
+                    lock_guard<mutex> lock(poll_mtx);
+                    if (stop) break;
+                    try {
+                        control.poll(progress);
+                    } catch (const SolverCancelled&) {
+                        failure = current_exception();
+                        stop = true;
+                    }
+                }
+                newly_total += newly;
+            };
+            if (num_threads > 1 && tasks.size() > 1) {
+                vector<thread> pool;
+                for (int t = 1; t < num_threads; ++t) pool.emplace_back(worker);
+                worker();
+                for (thread& th : pool) th.join();
+            } else {
+                worker();
+            }
+            if (failure) rethrow_exception(failure);
+            cur.swap(next);
+            changed = newly_total > 0;
+            progress.marked_pairs += newly_total;
+            progress.rounds++;
+        }
+        vector<uint64_t>().swap(next);
+
+        // 3. Gom nhóm bằng union-find theo hàng
+        vector<int> local = groupByUnionFind(m, [&](uint64_t i, uint64_t j) {
+            return !((cur[i * words + j / 64] >> (j % 64)) & 1);
+        }, progress);
+        vector<int> group(dfa.state_counter, -1);
+        for (uint64_t i = 0; i < m; ++i) group[ids[i]] = local[i];
+        return group;
+    }
+
+    // Table filling trên MappedPairTable: trạng thái được đánh số lại liên tục 0..m-1,
+    // bước cơ sở và các lượt quét duyệt theo tile; gom nhóm theo hàng (hàng i của tam
+    // giác nằm liên tiếp trong từng tile). Trả về group theo ID trạng thái gốc.
+    vector<int> groupMapped(DFA& dfa) {
+        vector<int> ids(dfa.states.begin(), dfa.states.end());
+        uint64_t m = ids.size();
+        int k = dfa.input_counter;
+        vector<int> index(dfa.state_counter, -1);
+        for (uint64_t i = 0; i < m; ++i) index[ids[i]] = (int)i;
+        vector<int> trans(m * k, -1);
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        for (uint64_t i = 0; i < m; ++i) {
+            for (auto const& p : dfa.transitions[ids[i]]) trans[i * k + p.first] = index[p.second];
+        }
+
+        MappedPairTable marked(m, temp_dir);
+        table_bytes = marked.file.bytes();
+        SolverProgress progress;
+
+        // 1. Bước cơ sở: cặp khác nhãn đầu ra (Final / Non-Final, hoặc accept_class)
+        marked.forEachPairTiled(control, progress, [&](uint64_t i, uint64_t j) {
+            if (label[ids[i]] != label[ids[j]]) { marked.set(i, j); progress.marked_pairs++; }
+        });
+
+        // 2. Các lượt quét cho tới khi không còn cặp mới
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            marked.forEachPairTiled(control, progress, [&](uint64_t i, uint64_t j) {
+                if (marked.get(i, j)) return;
+                for (int c = 0; c < k; ++c) {
+                    int t1 = trans[i * k + c], t2 = trans[j * k + c];
+                    if ((t1 == -1) != (t2 == -1) ||
+                        (t1 != -1 && t1 != t2 && marked.get(min(t1, t2), max(t1, t2)))) {
+                        marked.set(i, j);
+                        progress.marked_pairs++;
+                        changed = true;
+                        return;
+                    }
+                }
+            });
+            progress.rounds++;
+        }
+
+        // 3. Gom nhóm bằng union-find theo hàng
+        vector<int> local = groupByUnionFind(m, [&](uint64_t i, uint64_t j) { return !marked.get(i, j); }, progress);
+        table_resident_percent = residentPercent(marked.bits, marked.file.bytes());
+
+        vector<int> group(dfa.state_counter, -1);
+        for (uint64_t i = 0; i < m; ++i) group[ids[i]] = local[i];
+        return group;
+    }
+
+    // Table filling chỉ trên các cặp cùng khối thô. Phân hoạch thô = nhãn đầu ra (chấp
+    // nhận / không chấp nhận hoặc accept_class), tinh thêm tối đa coarse_rounds vòng Moore; hai trạng thái khác khối thô
+    // chắc chắn phân biệt nên không cần lưu. Mỗi khối B có bảng tam giác riêng
+    // |B| * (|B| - 1) / 2 bit, tổng bộ nhớ và chi phí quét là Σ|B|² thay vì n².
+    vector<int> groupBlocked(DFA& dfa, int rounds) {
+        vector<int> ids(dfa.states.begin(), dfa.states.end());
+        int m = ids.size();
+        int k = dfa.input_counter;
+        vector<int> index(dfa.state_counter, -1);
+        for (int i = 0; i < m; ++i) index[ids[i]] = i;
+        vector<int> trans((size_t)m * k, -1);
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        vector<int> coarse(m);
+        for (int i = 0; i < m; ++i) {
+            coarse[i] = label[ids[i]];
+            for (auto const& p : dfa.transitions[ids[i]]) trans[(size_t)i * k + p.first] = index[p.second];
+        }
+        SolverProgress progress;
+
+        // 1. Phân hoạch thô: nhãn đầu ra, rồi vài vòng Moore (dừng sớm khi số khối không đổi)
+        int num_coarse = num_labels;
+        for (int r = 0; r < rounds; ++r) {
+            control.poll(progress);
+            map<vector<int>, int> signatures;
+            vector<int> next(m);
+            for (int i = 0; i < m; ++i) {
+                vector<int> sig(k + 1);
+                sig[0] = coarse[i];
+                for (int c = 0; c < k; ++c) {
+                    int t = trans[(size_t)i * k + c];
+                    sig[c + 1] = (t == -1) ? -1 : coarse[t];
+                }
+                next[i] = signatures.emplace(sig, (int)signatures.size()).first->second;
+            }
+            bool stable = (int)signatures.size() == num_coarse;
+            num_coarse = signatures.size();
+            coarse.swap(next);
+            if (stable) break;
+        }
+        coarse_blocks = num_coarse;
+
+        // 2. Bảng tam giác riêng cho từng khối: cặp (a, b) với a < b ở bit b*(b-1)/2 + a
+        vector<vector<int>> members(num_coarse);
+        vector<int> local_id(m);
+        for (int i = 0; i < m; ++i) {
+            local_id[i] = members[coarse[i]].size();
+            members[coarse[i]].push_back(i);
+        }
+        vector<vector<bool>> marked(num_coarse);
+        table_bytes = 0;
+        for (int b = 0; b < num_coarse; ++b) {
+            size_t size = members[b].size();
+            marked[b].assign(size * (size - 1) / 2, false);
+            table_bytes += marked[b].size() / 8 + sizeof(vector<bool>);
+        }
+        auto pairIndex = [](size_t a, size_t b) { return b * (b - 1) / 2 + a; };
+        // Hai trạng thái phân biệt: khác khối thô, hoặc cùng khối và đã đánh dấu
+        auto distinct = [&](int u, int v) -> bool {
+            if (coarse[u] != coarse[v]) return true;
+            size_t a = local_id[u], b = local_id[v];
+            return marked[coarse[u]][a < b ? pairIndex(a, b) : pairIndex(b, a)];
+        };
+
+        // 3. Vòng lặp đánh dấu trong từng khối
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (int blk = 0; blk < num_coarse; ++blk) {
+                control.poll(progress);
+                const vector<int>& mem = members[blk];
+                for (size_t b = 1; b < mem.size(); ++b) {
+                    for (size_t a = 0; a < b; ++a) {
+                        if (marked[blk][pairIndex(a, b)]) continue;
+                        for (int c = 0; c < k; ++c) {
+                            int t1 = trans[(size_t)mem[a] * k + c], t2 = trans[(size_t)mem[b] * k + c];
+                            if ((t1 == -1) != (t2 == -1) || (t1 != -1 && t1 != t2 && distinct(t1, t2))) {
+                                marked[blk][pairIndex(a, b)] = true;
+                                progress.marked_pairs++;
+                                changed = true;
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+            progress.rounds++;
+        }
+
+        // 4. Gom nhóm bằng union-find trong từng khối, đánh số lớp nối tiếp giữa các khối
+        vector<int> group(dfa.state_counter, -1);
+        int group_count = 0;
+        for (int blk = 0; blk < num_coarse; ++blk) {
+            const vector<int>& mem = members[blk];
+            vector<int> local = groupByUnionFind(mem.size(), [&](size_t a, size_t b) {
+                return !marked[blk][pairIndex(a, b)];
+            }, progress);
+            int local_count = 0;
+            for (size_t a = 0; a < mem.size(); ++a) {
+                group[ids[mem[a]]] = group_count + local[a];
+                local_count = max(local_count, local[a] + 1);
+            }
+            group_count += local_count;
+        }
+        return group;
+    }
+
+public:
+    // Hủy / deadline / tiến độ, được kiểm tra ở ranh giới mỗi vòng tinh chỉnh
+    SolverControl control;
+    // Bảng marked: "memory" (vector<vector<bool>>, bản gốc một luồng), "tiled" (ma trận bit
+    // chia tile, song song), "blocked" (bảng riêng cho từng khối thô), "mmap"
+    // (MappedPairTable) hoặc "auto" (tiled nếu vừa memory_budget_bytes, ngược lại mmap)
+    string table_backend = "auto";
+    size_t memory_budget_bytes = (size_t)1024 << 20;
+    string temp_dir;
+    // Số luồng cho backend tiled
+    int threads = 1;
+    // Backend "blocked": số vòng Moore tinh phân hoạch thô sau bước chấp nhận
+    int coarse_rounds = 2;
+    // Thống kê bảng của lần chạy gần nhất
+    string used_backend;
+    int coarse_blocks = 0;
+    uint64_t table_bytes = 0;
+    double table_resident_percent = 0;
+
+    DFA minimize(DFA inputDFA) {
+        DFA dfa = removeUnreachable(inputDFA);
+        if (dfa.states.empty()) return dfa;
+
+        int n = dfa.state_counter;
+        used_backend = table_backend;
+        if (table_backend == "auto") {
+            // Backend tiled: hai ma trận m x ceil(m / 64) word (cur và next)
+            uint64_t m = dfa.states.size();
+            used_backend = (m * ((m + 63) / 64) * 16 <= memory_budget_bytes) ? "tiled" : "mmap";
+        }
+        if (used_backend == "mmap") return reconstructDFA(dfa, groupMapped(dfa));
+        if (used_backend == "tiled") return reconstructDFA(dfa, groupTiled(dfa, threads));
+        if (used_backend == "blocked") return reconstructDFA(dfa, groupBlocked(dfa, coarse_rounds));
+        if (used_backend != "memory") throw runtime_error("Backend bang khong hop le: " + table_backend);
+        // Bảng trong RAM: n hàng vector<bool>, mỗi hàng n bit + phần đầu
+        table_bytes = (uint64_t)n * (n / 8 + 1 + sizeof(vector<bool>));
+        // Bảng đánh dấu: marked[u][v] = true nếu u và v phân biệt
+        vector<vector<bool>> marked(n, vector<bool>(n, false));
+
+        // 1. Bước cơ sở: Đánh dấu cặp khác nhãn đầu ra (Final / Non-Final, hoặc accept_class)
+        SolverProgress progress;
+        int num_labels;
+        vector<int> label = outputLabels(dfa, num_labels);
+        for(int i : dfa.states) {
+            control.poll(progress);
+            for(int j : dfa.states) {
+                if(i < j) {
+                    if(label[i] != label[j]) { marked[i][j] = true; progress.marked_pairs++; }
+                }
+            }
+        }
+
+        // 2. Vòng lặp: Đánh dấu nếu chuyển đến cặp đã đánh dấu
+        bool changed = true;
+        while(changed) {
+            changed = false;
+            for(int i : dfa.states) {
+                control.poll(progress);
+                for(int j : dfa.states) {
+                    if(i < j && !marked[i][j]) {
+                        for(int c : dfa.alphabet) {
+                            int t1 = -1, t2 = -1;
+                            if(dfa.transitions[i].count(c)) t1 = dfa.transitions[i][c];
+                            if(dfa.transitions[j].count(c)) t2 = dfa.transitions[j][c];
+                            
+                            // Nếu một cái có cạnh, một cái không -> Phân biệt
+                            if((t1 == -1 && t2 != -1) || (t1 != -1 && t2 == -1)) {
+                                marked[i][j] = true;
+                                progress.marked_pairs++;
+                                changed = true;
+                                break;
+                            }
+                            
+                            // Nếu cả hai chuyển đến cặp đã mark
+                            if(t1 != -1 && t2 != -1) {
+                                int u = min(t1, t2);
+                                int v = max(t1, t2);
+                                if(u != v && marked[u][v]) {
+                                    marked[i][j] = true;
+                                    progress.marked_pairs++;
+                                    changed = true;
+                                    break;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+            progress.rounds++;
+        }
+
+        // 3. Gom nhóm các trạng thái tương đương bằng union-find theo hàng
+        vector<int> ids(dfa.states.begin(), dfa.states.end());
+        vector<int> local = groupByUnionFind(ids.size(), [&](size_t a, size_t b) { return !marked[ids[a]][ids[b]]; }, progress);
+        vector<int> group(n, -1);
+        for (size_t a = 0; a < ids.size(); ++a) group[ids[a]] = local[a];
+
+        return reconstructDFA(dfa, group);
+    }
+};
+
+#endif // TABLE_FILLING_HPP
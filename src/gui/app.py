@@ -4,6 +4,7 @@ import subprocess
 import os
 import graphviz
 import time
+from cost_model import ENGINES, extract_features, load_model, choose_engine, is_calibrated
 
 # --- 1. CẤU HÌNH HỆ THỐNG ---
 # Tự động định vị đường dẫn tuyệt đối (tránh lỗi file not found)
@@ -19,9 +20,14 @@ os.makedirs(DATA_DIR, exist_ok=True)
 ALGO_MAP = {
     "Hopcroft Algorithm (O(N log N))": "hopcroft_solver.exe",
     "Moore Algorithm (O(N^2))": "moore_solver.exe",
-    "Table Filling Algorithm (O(N^2))": "table_filling_solver.exe"
+    "Table Filling Algorithm (O(N^2))": "table_filling_solver.exe",
+    "Brzozowski Algorithm (Double Reversal)": "brzozowski_solver.exe",
+    "Portfolio (chạy song song, lấy kết quả nhanh nhất)": "portfolio_solver.exe"
 }
 
+# Chế độ tự động: chọn engine nhanh nhất theo mô hình chi phí (xem cost_model.py)
+AUTO_OPTION = "Tự động (Cost model)"
+
 st.set_page_config(
     page_title="Automata Minimizer", 
     layout="wide", 
@@ -54,14 +60,17 @@ def draw_dfa(dfa_data):
             dot.node('start_pointer', '', shape='none', width='0')
             dot.edge('start_pointer', name)
             
-        dot.node(name, shape=shape, style=style, fillcolor=fillcolor, color=color)
+        # Nhãn đầu ra (token của lexer) hiển thị dưới tên trạng thái
+        node_label = f"{name}\n{state['accept_class']}" if state.get('accept_class') else name
+        dot.node(name, label=node_label, shape=shape, style=style, fillcolor=fillcolor, color=color)
         
         # Vẽ các Chuyển đổi (Edges)
         # Gom nhóm các input cùng đích đến (ví dụ: 0,1 -> B)
         transitions = {}
         for t in state.get('transitions', []):
             target = t['target_state']
-            inp = t['input']
+            # Máy Mealy: hiển thị input/output
+            inp = f"{t['input']}/{t['output']}" if t.get('output') else t['input']
             if target not in transitions: transitions[target] = []
             transitions[target].append(inp)
             
@@ -72,7 +81,7 @@ def draw_dfa(dfa_data):
     return dot
 
 # --- 3. HÀM GỌI C++ BACKEND ---
-def run_solver(exe_name, input_data):
+def run_solver(exe_name, input_data, deadline_ms=0, progress_box=None):
     """Quy trình: Ghi Input -> Gọi EXE -> Đọc Output"""
     input_path = os.path.join(DATA_DIR, "temp_input.json")
     output_path = os.path.join(DATA_DIR, "temp_output.json")
@@ -90,20 +99,35 @@ def run_solver(exe_name, input_data):
         return False, f"LỖI: Không tìm thấy file '{exe_name}' trong thư mục bin/.\nHãy biên dịch C++ trước!", 0
 
     # B3: Gọi subprocess chạy file EXE
+    # Lệnh tương đương: ./solver.exe input.json output.json [--deadline-ms N] [--progress]
+    cmd = [exe_path, input_path, output_path]
+    if deadline_ms > 0:
+        cmd += ["--deadline-ms", str(deadline_ms)]
+    # Portfolio chạy nhiều luồng nên không in tiến độ
+    if progress_box is not None and exe_name != "portfolio_solver.exe":
+        cmd.append("--progress")
     try:
         start_time = time.time()
-        # Lệnh tương đương: ./solver.exe input.json output.json
-        process = subprocess.run(
-            [exe_path, input_path, output_path],
-            capture_output=True, 
-            text=True
-        )
+        process = subprocess.Popen(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+        # Solver in tiến độ ra stderr theo từng dòng "Progress: ..."
+        errors = []
+        for line in process.stderr:
+            if line.startswith("Progress:") and progress_box is not None:
+                progress_box.text(line.strip())
+            else:
+                errors.append(line)
+        process.stdout.read()
+        process.wait()
         end_time = time.time()
         runtime_ms = (end_time - start_time) * 1000 # Đổi sang miliseconds
+        if progress_box is not None:
+            progress_box.empty()
         
-        # Kiểm tra mã lỗi trả về từ C++
+        # Kiểm tra mã lỗi trả về từ C++ (3 = bị hủy do vượt deadline)
+        if process.returncode == 3:
+            return False, f"Solver bị hủy do vượt deadline {deadline_ms} ms:\n{''.join(errors)}", 0
         if process.returncode != 0:
-            return False, f"C++ Runtime Error:\n{process.stderr}", 0
+            return False, f"C++ Runtime Error:\n{''.join(errors)}", 0
             
     except Exception as e:
         return False, f"Lỗi khi gọi file EXE: {str(e)}", 0
@@ -121,7 +145,7 @@ def run_solver(exe_name, input_data):
 
 # --- 4. GIAO DIỆN CHÍNH (STREAMLIT UI) ---
 st.title("🔬 Nghiên cứu Tối thiểu hóa Automata")
-st.markdown("Hệ thống so sánh hiệu năng giữa **Hopcroft**, **Moore** và **Table Filling**.")
+st.markdown("Hệ thống so sánh hiệu năng giữa **Hopcroft**, **Moore**, **Table Filling** và **Brzozowski**.")
 st.markdown("---")
 
 # Sidebar: Cấu hình
@@ -130,7 +154,8 @@ with st.sidebar:
     uploaded_file = st.file_uploader("Upload file JSON DFA", type=["json"])
     
     st.header("2. Chọn Thuật toán")
-    algo_option = st.radio("Phương pháp:", list(ALGO_MAP.keys()))
+    algo_option = st.radio("Phương pháp:", list(ALGO_MAP.keys()) + [AUTO_OPTION])
+    deadline_ms = st.number_input("Deadline (ms, 0 = không giới hạn)", min_value=0, value=0, step=1000)
     
     st.markdown("---")
     btn_run = st.button("🚀 TỐI ƯU HÓA", type="primary", use_container_width=True)
@@ -164,11 +189,18 @@ with col_output:
     st.subheader("📤 DFA Tối thiểu")
     
     if btn_run and input_data:
-        exe_file = ALGO_MAP[algo_option]
+        predicted_ms = None
+        if algo_option == AUTO_OPTION:
+            engine, predicted_ms, _ = choose_engine(extract_features(input_data), load_model())
+            exe_file = ENGINES[engine]
+            algo_label = f"{engine} (auto)"
+        else:
+            exe_file = ALGO_MAP[algo_option]
+            algo_label = algo_option.split(" ")[0]
         
         with st.spinner("Đang xử lý tại Backend C++..."):
             # Gọi hàm xử lý
-            success, result_data, runtime = run_solver(exe_file, input_data)
+            success, result_data, runtime = run_solver(exe_file, input_data, deadline_ms, st.empty())
             
         if success:
             # Hiển thị Metrics (Chỉ số)
@@ -179,7 +211,10 @@ with col_output:
             m1, m2, m3 = st.columns(3)
             m1.metric("Trạng thái mới", f"{n_new}", delta=f"-{reduced} removed")
             m2.metric("Thời gian chạy", f"{runtime:.2f} ms")
-            m3.metric("Thuật toán", algo_option.split(" ")[0])
+            m3.metric("Thuật toán", algo_label)
+            if predicted_ms is not None:
+                note = "" if is_calibrated() else " (chưa hiệu chỉnh, chạy `cost_model.py --calibrate` để dự đoán chính xác)"
+                st.caption(f"Cost model chọn **{algo_label}**, thời gian dự đoán: {predicted_ms:.2f} ms{note}")
             
             # Vẽ hình kết quả
             st.success("Tối ưu hóa thành công!")
@@ -190,7 +225,7 @@ with col_output:
             st.download_button(
                 label="Tải kết quả (JSON)",
                 data=out_json,
-                file_name=f"minimized_{algo_option.split()[0]}.json",
+                file_name=f"minimized_{algo_label.split()[0]}.json",
                 mime="application/json"
             )
         else:
@@ -0,0 +1,238 @@
+"""Chọn thuật toán tự động (--algo auto) bằng mô hình chi phí.
+
+Mỗi engine có mô hình tuyến tính  time_ms = c0 + c1 * basis(features),  với basis
+là độ phức tạp lý thuyết của engine. Hệ số (c0, c1) được hiệu chỉnh trên chính máy
+đang chạy từ metrics mà các solver in ra (Wall_Time_ms):
+
+    python src/gui/cost_model.py --calibrate exp/exp_json/*.json
+    python src/gui/cost_model.py --algo auto data/input.json data/output.json
+
+Table filling không bao giờ bị loại: `--table auto` dùng bảng tiled trong RAM khi vừa
+ngân sách, ngược lại chuyển sang bảng ánh xạ file (mmap), nên engine này có hai bộ hệ số
+("table_filling" và "table_filling_mmap") chọn theo kích thước bảng tiled.
+
+Brzozowski không tham gia chọn tự động: chi phí phụ thuộc kích thước DFA đảo sau khi
+tất định hóa, không ước lượng được trước khi chạy.
+"""
+import argparse
+import json
+import math
+import os
+import subprocess
+import sys
+
+# --- 1. CẤU HÌNH ---
+CURRENT_DIR = os.path.dirname(os.path.abspath(__file__))
+PROJECT_ROOT = os.path.dirname(os.path.dirname(CURRENT_DIR))
+BIN_DIR = os.path.join(PROJECT_ROOT, "bin")
+DATA_DIR = os.path.join(PROJECT_ROOT, "data")
+MODEL_PATH = os.path.join(DATA_DIR, "cost_model.json")
+
+ENGINES = {
+    "hopcroft": "hopcroft_solver.exe",
+    "moore": "moore_solver.exe",
+    "table_filling": "table_filling_solver.exe",
+}
+
+# Hệ số mặc định khi chưa hiệu chỉnh: chỉ là ước lượng thô, có thể sai hàng chục lần;
+# dự đoán dùng các hệ số này được đánh dấu "uncalibrated"
+DEFAULT_MODEL = {
+    "hopcroft": {"c0": 0.5, "c1": 2e-4},
+    "moore": {"c0": 0.3, "c1": 1e-7},
+    "table_filling": {"c0": 0.1, "c1": 1e-6},
+    "table_filling_mmap": {"c0": 0.1, "c1": 1e-5},
+}
+
+DEFAULT_MEM_BUDGET_MB = 1024
+
+
+# --- 2. ĐẶC TRƯNG CỦA DFA ---
+def extract_features(dfa_data):
+    """n, |Σ|, số cạnh, mật độ, tính không chu trình, bộ nhớ bảng tiled (bytes)."""
+    index = {s["state_name"]: i for i, s in enumerate(dfa_data)}
+    symbols = set()
+    succ = [[] for _ in dfa_data]
+    m = 0
+    for i, state in enumerate(dfa_data):
+        for t in state.get("transitions", []):
+            symbols.add(t["input"])
+            target = index.setdefault(t["target_state"], len(index))
+            if target >= len(succ):
+                succ.append([])
+            succ[i].append(target)
+            m += 1
+    n = len(index)
+    sigma = max(len(symbols), 1)
+
+    # Sắp xếp topo (Kahn) để phát hiện chu trình
+    indeg = [0] * n
+    for targets in succ:
+        for v in targets:
+            indeg[v] += 1
+    stack = [u for u in range(n) if indeg[u] == 0]
+    visited = 0
+    while stack:
+        u = stack.pop()
+        visited += 1
+        for v in succ[u]:
+            indeg[v] -= 1
+            if indeg[v] == 0:
+                stack.append(v)
+
+    return {
+        "n": n,
+        "sigma": sigma,
+        "m": m,
+        "density": m / (n * sigma) if n else 0.0,
+        "acyclic": visited == n,
+        # --table auto: hai ma trận bit n x ceil(n/64) word (vòng trước / vòng sau)
+        "table_bytes": n * ((n + 63) // 64) * 16,
+    }
+
+
+def basis(engine, f):
+    """Độ phức tạp lý thuyết của engine theo đặc trưng f."""
+    n, m = max(f["n"], 1), f["m"]
+    if engine == "hopcroft":
+        # DFA không chu trình đi đường Revuz tuyến tính
+        return n + m if f["acyclic"] else m * math.log2(n + 1)
+    if engine == "moore":
+        # Tối đa n vòng, mỗi vòng tính chữ ký trên các cạnh có thật: O(n * |Σ| * density)
+        return n * f["sigma"] * f["density"] * n
+    if engine == "table_filling":
+        return n * n * f["sigma"]
+    raise ValueError(f"Engine không hợp lệ: {engine}")
+
+
+# --- 3. MÔ HÌNH CHI PHÍ ---
+def is_calibrated(path=MODEL_PATH):
+    """True nếu đã có hệ số hiệu chỉnh trên máy này (data/cost_model.json)."""
+    return os.path.exists(path)
+
+
+def load_model(path=MODEL_PATH):
+    model = {k: dict(v) for k, v in DEFAULT_MODEL.items()}
+    if os.path.exists(path):
+        with open(path, "r") as f:
+            model.update(json.load(f).get("engines", {}))
+    return model
+
+
+def model_key(engine, f, mem_budget_mb=DEFAULT_MEM_BUDGET_MB):
+    """Bộ hệ số dùng cho engine: table filling có bảng tiled vượt ngân sách chạy trên mmap."""
+    if engine == "table_filling" and f["table_bytes"] > mem_budget_mb * 1024 * 1024:
+        return "table_filling_mmap"
+    return engine
+
+
+def predict(engine, f, model, mem_budget_mb=DEFAULT_MEM_BUDGET_MB):
+    coef = model[model_key(engine, f, mem_budget_mb)]
+    return coef["c0"] + coef["c1"] * basis(engine, f)
+
+
+def choose_engine(f, model, mem_budget_mb=DEFAULT_MEM_BUDGET_MB):
+    """Trả về (engine, thời gian dự đoán ms, dict dự đoán của mọi engine)."""
+    predictions = {engine: predict(engine, f, model, mem_budget_mb) for engine in ENGINES}
+    best = min(predictions, key=predictions.get)
+    return best, predictions[best], predictions
+
+
+def fit(samples):
+    """Hồi quy tuyến tính time = c0 + c1 * basis (bình phương tối thiểu, hệ số >= 0)."""
+    if not samples:
+        return None
+    xs = [x for x, _ in samples]
+    ys = [y for _, y in samples]
+    mean_x, mean_y = sum(xs) / len(xs), sum(ys) / len(ys)
+    var_x = sum((x - mean_x) ** 2 for x in xs)
+    if var_x == 0:
+        c1 = mean_y / mean_x if mean_x else 0.0
+        return {"c0": 0.0, "c1": max(c1, 0.0)}
+    c1 = max(sum((x - mean_x) * (y - mean_y) for x, y in samples) / var_x, 0.0)
+    c0 = max(mean_y - c1 * mean_x, 0.0)
+    return {"c0": c0, "c1": c1}
+
+
+# --- 4. GỌI SOLVER ---
+def parse_metrics(stdout):
+    metrics = {}
+    for line in stdout.splitlines():
+        if ":" in line:
+            key, value = line.split(":", 1)
+            metrics[key.strip()] = value.strip()
+    return metrics
+
+
+def run_engine(engine, input_path, output_path, bin_dir=BIN_DIR, mem_budget_mb=DEFAULT_MEM_BUDGET_MB):
+    exe_path = os.path.join(bin_dir, ENGINES[engine])
+    command = [exe_path, input_path, output_path]
+    if engine == "table_filling":
+        command += ["--mem-budget-mb", str(mem_budget_mb)]  # Cùng ngưỡng tiled / mmap với model_key
+    process = subprocess.run(command, capture_output=True, text=True)
+    if process.returncode != 0:
+        raise RuntimeError(f"{ENGINES[engine]} lỗi:\n{process.stderr}")
+    return process.stdout
+
+
+def calibrate(input_paths, bin_dir=BIN_DIR, path=MODEL_PATH, mem_budget_mb=DEFAULT_MEM_BUDGET_MB):
+    """Chạy mọi engine trên các input, đọc Wall_Time_ms và hiệu chỉnh lại mô hình."""
+    samples = {key: [] for key in DEFAULT_MODEL}
+    output_path = os.path.join(DATA_DIR, "calibration_output.json")
+    for input_path in input_paths:
+        with open(input_path, "r") as f:
+            features = extract_features(json.load(f))
+        for engine in ENGINES:
+            metrics = parse_metrics(run_engine(engine, input_path, output_path, bin_dir, mem_budget_mb))
+            key = engine
+            if metrics.get("Table_Backend") == "mmap":
+                key = "table_filling_mmap"
+            samples[key].append((basis(engine, features), float(metrics["Wall_Time_ms"])))
+
+    model = load_model(path)
+    for engine, data in samples.items():
+        coef = fit(data)
+        if coef:
+            model[engine] = coef
+    os.makedirs(os.path.dirname(path), exist_ok=True)
+    with open(path, "w") as f:
+        json.dump({"engines": model, "samples": samples}, f, indent=4)
+    return model
+
+
+# --- 5. CLI ---
+def main():
+    parser = argparse.ArgumentParser(description="Chọn thuật toán tối thiểu hóa DFA theo mô hình chi phí")
+    parser.add_argument("--algo", default="auto", choices=["auto"] + list(ENGINES))
+    parser.add_argument("--calibrate", action="store_true", help="Hiệu chỉnh mô hình từ các file input")
+    parser.add_argument("--mem-budget-mb", type=float, default=DEFAULT_MEM_BUDGET_MB)
+    parser.add_argument("--bin-dir", default=BIN_DIR)
+    parser.add_argument("files", nargs="+")
+    args = parser.parse_args()
+
+    if args.calibrate:
+        model = calibrate(args.files, args.bin_dir, mem_budget_mb=args.mem_budget_mb)
+        print(json.dumps(model, indent=4))
+        return 0
+
+    input_path = args.files[0]
+    output_path = args.files[1] if len(args.files) > 1 else "output.json"
+    with open(input_path, "r") as f:
+        features = extract_features(json.load(f))
+    model = load_model()
+    if args.algo == "auto":
+        engine, predicted, _ = choose_engine(features, model, args.mem_budget_mb)
+    else:
+        engine, predicted = args.algo, predict(args.algo, features, model, args.mem_budget_mb)
+
+    sys.stdout.write(run_engine(engine, input_path, output_path, args.bin_dir, args.mem_budget_mb))
+    print(f"Auto_Engine: {engine}")
+    print(f"Predicted_Time_ms: {predicted:.3f}")
+    print(f"Cost_Model: {'calibrated' if is_calibrated() else 'uncalibrated'}")
+    if not is_calibrated():
+        print("WARNING: chua hieu chinh mo hinh chi phi (chay --calibrate), "
+              "Predicted_Time_ms chi la uoc luong tho", file=sys.stderr)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())